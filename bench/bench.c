@@ -0,0 +1,351 @@
+/**
+ * @file bench.c
+ * @author Letter (NevermindZZT@gmail.com)
+ * @brief shell host benchmark
+ * @version 1.0.0
+ * @date 2019-12-10
+ * 
+ * @Copyright (c) 2019 Letter
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "shell.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define     BENCH_TICK()                __rdtsc()
+#define     BENCH_UNIT                  "cycles"
+#else
+#define     BENCH_TICK()                benchNanosecond()
+#define     BENCH_UNIT                  "ns"
+#endif
+
+/**
+ * @brief 合成命令
+ * 
+ * @note 模拟产品中的命令表规模，共32条，命令名为bench00 - bench31
+ */
+#define     BENCH_COMMAND(n)            SHELL_EXPORT_CMD(bench##n, benchNop, synthetic command)
+
+/**
+ * @brief 块输入长度
+ * 
+ * @note 使用`-b`选项时，按键序列按此长度分块交给shellHandlerBuffer，模拟串口DMA接收
+ */
+#define     BENCH_CHUNK_SIZE            64
+
+/**
+ * @brief 按键序列定义
+ * 
+ */
+typedef struct
+{
+    const char *name;                                       /**< 序列名 */
+    const char *data;                                       /**< 按键数据 */
+    unsigned int length;                                    /**< 按键数据长度 */
+} BENCH_StreamDef;
+
+#define     BENCH_STREAM(name, data)    {name, data, sizeof(data) - 1}
+
+/**
+ * @brief 内置按键序列
+ * 
+ * @note 录制自串口终端，方向键为CSI序列，退格为0x08
+ */
+static const BENCH_StreamDef benchStreamList[] =
+{
+    BENCH_STREAM("type",
+                 "bench00\r"
+                 "add 10 20\r"
+                 "bench17 1 2 3\r"
+                 "echo hello\r"
+                 "add 0x7f -3\r"
+                 "echo \"quoted string\"\r"),
+    BENCH_STREAM("edit",
+                 "add 1 3\x08" "2\r"
+                 "ech\x1b[D\x1b[D\x1b[C\x1b[C" "o edit\r"
+                 "addd\x1b[D\x1b[3~ 5 6\r"
+                 "bench31\x1b[H\x1b[F\r"),
+    BENCH_STREAM("tab",
+                 "ad\t 1 1\r"
+                 "ech\t tab\r"
+                 "bench2\t\x08\x08\x08\x08\x08\x08\x08\x08\r"
+                 "\t\r"),
+    BENCH_STREAM("history",
+                 "add 2 3\r"
+                 "\x1b[A\r"
+                 "echo history\r"
+                 "\x1b[A\x1b[A\x1b[B\r"),
+    BENCH_STREAM("help",
+                 "help\r"),
+};
+
+static unsigned long benchWriteCount;                       /**< 写函数调用次数 */
+static unsigned long benchWriteBytes;                       /**< 写出的字节数 */
+static int benchVerbose;                                    /**< 是否输出shell的输出 */
+static SHELL_TypeDef benchShell;                            /**< 测试shell */
+
+
+#if !defined(__x86_64__) && !defined(__i386__)
+/**
+ * @brief 获取单调时间
+ * 
+ * @return unsigned long long 时间(ns)
+ */
+static unsigned long long benchNanosecond(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+#endif
+
+
+/**
+ * @brief 测试写字符
+ * 
+ * @param data 字符
+ */
+static void benchWrite(const char data)
+{
+    benchWriteCount++;
+    benchWriteBytes++;
+    if (benchVerbose)
+    {
+        putchar(data);
+    }
+}
+
+
+/**
+ * @brief 测试块写数据
+ * 
+ * @param data 数据
+ * @param length 数据长度
+ */
+static void benchWriteBuffer(const char *data, unsigned short length)
+{
+    benchWriteCount++;
+    benchWriteBytes += length;
+    if (benchVerbose)
+    {
+        fwrite(data, 1, length, stdout);
+    }
+#if SHELL_TX_BUFFER_SIZE > 0
+    shellTxComplete(&benchShell);
+#endif /** SHELL_TX_BUFFER_SIZE > 0 */
+}
+
+
+/**
+ * @brief 空命令
+ * 
+ * @return int 0
+ */
+int benchNop(void)
+{
+    return 0;
+}
+
+
+/**
+ * @brief 加法命令
+ * 
+ * @param a 加数
+ * @param b 加数
+ * @return int 和
+ */
+int benchAdd(int a, int b)
+{
+    return a + b;
+}
+
+
+/**
+ * @brief 回显命令
+ * 
+ * @param string 字符串
+ * @return int 0
+ */
+int benchEcho(const char *string)
+{
+    shellPrint(shellGetCurrent(), "%s\r\n", string);
+    return 0;
+}
+
+SHELL_EXPORT_CMD(add, benchAdd, add two numbers);
+SHELL_EXPORT_CMD(echo, benchEcho, echo a string);
+BENCH_COMMAND(00); BENCH_COMMAND(01); BENCH_COMMAND(02); BENCH_COMMAND(03);
+BENCH_COMMAND(04); BENCH_COMMAND(05); BENCH_COMMAND(06); BENCH_COMMAND(07);
+BENCH_COMMAND(08); BENCH_COMMAND(09); BENCH_COMMAND(10); BENCH_COMMAND(11);
+BENCH_COMMAND(12); BENCH_COMMAND(13); BENCH_COMMAND(14); BENCH_COMMAND(15);
+BENCH_COMMAND(16); BENCH_COMMAND(17); BENCH_COMMAND(18); BENCH_COMMAND(19);
+BENCH_COMMAND(20); BENCH_COMMAND(21); BENCH_COMMAND(22); BENCH_COMMAND(23);
+BENCH_COMMAND(24); BENCH_COMMAND(25); BENCH_COMMAND(26); BENCH_COMMAND(27);
+BENCH_COMMAND(28); BENCH_COMMAND(29); BENCH_COMMAND(30); BENCH_COMMAND(31);
+
+#if SHELL_USING_VAR == 1
+int benchValue = 0;
+SHELL_EXPORT_VAR_INT(benchValue, benchValue, bench variable);
+#endif /** SHELL_USING_VAR == 1 */
+
+
+/**
+ * @brief 读取录制的按键序列文件
+ * 
+ * @param path 文件路径
+ * @param stream 按键序列
+ * @return int 0 读取成功 -1 读取失败
+ */
+static int benchLoad(const char *path, BENCH_StreamDef *stream)
+{
+    FILE *file = fopen(path, "rb");
+    char *data;
+    long length;
+
+    if (!file)
+    {
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data = malloc(length + 1);
+    if (!data || fread(data, 1, length, file) != (size_t)length)
+    {
+        fclose(file);
+        free(data);
+        return -1;
+    }
+    fclose(file);
+    stream->name = path;
+    stream->data = data;
+    stream->length = length;
+    return 0;
+}
+
+
+/**
+ * @brief 回放按键序列并输出统计
+ * 
+ * @param stream 按键序列
+ * @param repeat 回放次数
+ * @param block 是否按块输入
+ */
+static void benchRun(const BENCH_StreamDef *stream, unsigned int repeat, int block)
+{
+    unsigned long long start;
+    unsigned long long ticks;
+    unsigned int commands = 0;
+    unsigned int chunk;
+
+    for (unsigned int i = 0; i < stream->length; i++)
+    {
+        if (stream->data[i] == '\r' || stream->data[i] == '\n')
+        {
+            commands++;
+        }
+    }
+    benchWriteCount = 0;
+    benchWriteBytes = 0;
+    start = BENCH_TICK();
+    for (unsigned int n = 0; n < repeat; n++)
+    {
+        if (block)
+        {
+            for (unsigned int i = 0; i < stream->length; i += chunk)
+            {
+                chunk = stream->length - i;
+                chunk = chunk < BENCH_CHUNK_SIZE ? chunk : BENCH_CHUNK_SIZE;
+                shellInputBuffer(&benchShell, stream->data + i, chunk);
+            }
+        }
+        else
+        {
+            for (unsigned int i = 0; i < stream->length; i++)
+            {
+                shellInput(&benchShell, stream->data[i]);
+            }
+        }
+    }
+    ticks = BENCH_TICK() - start;
+
+    printf("%-12s %8u %6u %14.1f %14.1f %12.2f %12.1f\n",
+           stream->name, stream->length, commands,
+           (double)ticks / ((double)stream->length * repeat),
+           commands ? (double)ticks / ((double)commands * repeat) : 0.0,
+           commands ? (double)benchWriteCount / ((double)commands * repeat) : 0.0,
+           commands ? (double)benchWriteBytes / ((double)commands * repeat) : 0.0);
+}
+
+
+/**
+ * @brief 主机性能测试
+ * 
+ * @note 用法: bench [-n 次数] [-b] [-w] [-v] [按键序列文件...]
+ *       -b 按块输入(shellHandlerBuffer)，-w 使用块写(shell.writeBuffer)，
+ *       -v 输出shell的输出，用于检查按键序列，不指定文件时回放内置按键序列
+ */
+int main(int argc, char *argv[])
+{
+    unsigned int repeat = 1000;
+    int block = 0;
+    int files = 0;
+    BENCH_StreamDef stream;
+
+    benchShell.write = benchWrite;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            repeat = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-b") == 0)
+        {
+            block = 1;
+        }
+        else if (strcmp(argv[i], "-w") == 0)
+        {
+            benchShell.writeBuffer = benchWriteBuffer;
+        }
+        else if (strcmp(argv[i], "-v") == 0)
+        {
+            benchVerbose = 1;
+        }
+    }
+    shellInit(&benchShell);
+
+    printf("%-12s %8s %6s %14s %14s %12s %12s\n", "stream", "bytes", "cmds",
+           BENCH_UNIT "/byte", BENCH_UNIT "/cmd", "writes/cmd", "bytes/cmd");
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0)
+        {
+            i++;
+        }
+        else if (argv[i][0] != '-')
+        {
+            files++;
+            if (benchLoad(argv[i], &stream) != 0)
+            {
+                fprintf(stderr, "can not read %s\n", argv[i]);
+                return 1;
+            }
+            benchRun(&stream, repeat, block);
+            free((void *)stream.data);
+        }
+    }
+    if (files == 0)
+    {
+        for (unsigned int i = 0; i < sizeof(benchStreamList) / sizeof(BENCH_StreamDef); i++)
+        {
+            benchRun(&benchStreamList[i], repeat, block);
+        }
+    }
+    return 0;
+}
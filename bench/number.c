@@ -0,0 +1,372 @@
+/**
+ * @file number.c
+ * @author Letter (NevermindZZT@gmail.com)
+ * @brief shell number parser benchmark
+ * @version 1.0.0
+ * @date 2019-12-10
+ * 
+ * @Copyright (c) 2019 Letter
+ * 
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "shell.h"
+#include "shell_ext.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define     BENCH_TICK()                __rdtsc()
+#define     BENCH_UNIT                  "cycles"
+#else
+#define     BENCH_TICK()                benchNanosecond()
+#define     BENCH_UNIT                  "ns"
+#endif
+
+/**
+ * @brief 测试数据长度
+ * 
+ */
+#define     NUMBER_LENGTH               40
+
+/**
+ * @brief 测试数据类别
+ * 
+ */
+enum
+{
+    NUMBER_DEC = 0,                                         /**< 十进制整型 */
+    NUMBER_HEX,                                             /**< 十六进制整型 */
+    NUMBER_BIN,                                             /**< 二进制整型 */
+    NUMBER_OCT,                                             /**< 八进制整型 */
+    NUMBER_OVERFLOW,                                        /**< 超出32位的整型 */
+    NUMBER_FLOAT_SHORT,                                     /**< 尾数不超过2^24，指数不超过10的浮点数 */
+    NUMBER_FLOAT_LONG,                                      /**< 长尾数或大指数的浮点数 */
+    NUMBER_CLASS,
+};
+
+static const char *numberClassName[NUMBER_CLASS] =
+{
+    "dec", "hex", "bin", "oct", "overflow", "float", "float-long"
+};
+
+static unsigned long long numberSeed = 0x9E3779B97F4A7C15ULL;   /**< 随机数种子 */
+
+#if SHELL_USING_VAR == 1
+int numberValue = 0;
+SHELL_EXPORT_VAR_INT(numberValue, numberValue, number variable);
+#endif /** SHELL_USING_VAR == 1 */
+
+
+#if !defined(__x86_64__) && !defined(__i386__)
+/**
+ * @brief 获取单调时间
+ * 
+ * @return unsigned long long 时间(ns)
+ */
+static unsigned long long benchNanosecond(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+#endif
+
+
+/**
+ * @brief 随机数
+ * 
+ * @return unsigned long long 随机数(xorshift64)，种子固定，每次运行结果相同
+ */
+static unsigned long long numberRandom(void)
+{
+    numberSeed ^= numberSeed << 13;
+    numberSeed ^= numberSeed >> 7;
+    numberSeed ^= numberSeed << 17;
+    return numberSeed;
+}
+
+
+/**
+ * @brief 改写前的数字解析
+ * 
+ * @param string 字符串参数
+ * @return unsigned int 解析出的数字，浮点数以其二进制表示返回
+ * 
+ * @note 用于对比性能，不支持指数，溢出时不报错
+ */
+static unsigned int legacyParseNumber(char *string)
+{
+    char *p = string;
+    char radix = 10;
+    char offset = 0;
+    signed char sign = 1;
+    unsigned int valueInt = 0;
+    unsigned int devide = 0;
+    char isFloat = 0;
+    union
+    {
+        unsigned int value;
+        float valueFloat;
+    } result;
+
+    if (*string == '-')
+    {
+        sign = -1;
+        p++;
+    }
+    if (*p == '0' && (*(p + 1) == 'x' || *(p + 1) == 'X'))
+    {
+        radix = 16;
+        offset = 2;
+    }
+    else if (*p == '0' && (*(p + 1) == 'b' || *(p + 1) == 'B'))
+    {
+        radix = 2;
+        offset = 2;
+    }
+    else if (*p == '0')
+    {
+        radix = 8;
+        offset = 1;
+    }
+    for (char *q = p; *q++; )
+    {
+        if (*q == '.' && *(q + 1) != 0)
+        {
+            isFloat = 1;
+            radix = 10;
+            offset = 0;
+            break;
+        }
+    }
+    p += offset;
+    while (*p)
+    {
+        if (*p == '.')
+        {
+            devide = 1;
+            p++;
+            continue;
+        }
+        valueInt = valueInt * radix
+                   + ((*p >= 'a') ? *p - 'a' + 10 : (*p >= 'A') ? *p - 'A' + 10 : *p - '0');
+        devide *= 10;
+        p++;
+    }
+    if (isFloat && devide != 0)
+    {
+        result.valueFloat = (float)valueInt / devide * sign;
+        return result.value;
+    }
+    return valueInt * sign;
+}
+
+
+/**
+ * @brief 生成测试数据
+ * 
+ * @param type 数据类别
+ * @param buffer 生成的字符串
+ */
+static void numberGenerate(int type, char *buffer)
+{
+    unsigned long long r = numberRandom();
+    unsigned int digits;
+    int length = 0;
+
+    switch (type)
+    {
+    case NUMBER_DEC:
+        if (r & 1)
+        {
+            sprintf(buffer, "%d", (int)(unsigned int)(r >> 8) >> (r >> 59));
+        }
+        else
+        {
+            sprintf(buffer, "%u", (unsigned int)(r >> 8) >> (r >> 59));
+        }
+        break;
+    case NUMBER_HEX:
+        sprintf(buffer, (r & 1) ? "0x%x" : "0X%X", (unsigned int)(r >> 8) >> (r >> 59));
+        break;
+    case NUMBER_BIN:
+        r = (unsigned int)(r >> 8) >> (r >> 59);
+        length = sprintf(buffer, "0b");
+        digits = 32;
+        while (digits > 1 && !(r >> (digits - 1) & 1))
+        {
+            digits--;
+        }
+        while (digits--)
+        {
+            buffer[length++] = '0' + ((r >> digits) & 1);
+        }
+        buffer[length] = 0;
+        break;
+    case NUMBER_OCT:
+        sprintf(buffer, "0%o", (unsigned int)(r >> 8) >> (r >> 59));
+        break;
+    case NUMBER_OVERFLOW:
+        sprintf(buffer, (r & 1) ? "%llu" : "0x%llx",
+                0x100000000ULL + ((r >> 8) & 0xFFFFFFFFFFULL));
+        break;
+    case NUMBER_FLOAT_SHORT:
+        if ((r >> 4) & 1)
+        {
+            sprintf(buffer, "%s%llue%d", (r & 1) ? "-" : "",
+                    (r >> 8) % 10000000ULL, (int)((r >> 40) % 21) - 10);
+        }
+        else
+        {
+            sprintf(buffer, "%s%s%llu.%03llu", (r & 1) ? "-" : "", ((r >> 5) & 1) ? "0" : "",
+                    (r >> 8) % 10000ULL, (r >> 32) % 1000ULL);
+        }
+        break;
+    case NUMBER_FLOAT_LONG:
+        length = sprintf(buffer, "%s%llu.%llu", (r & 1) ? "-" : "",
+                         (r >> 8) % 100000000000ULL, numberRandom() % 100000000ULL);
+        sprintf(buffer + length, "e%d", (int)((r >> 48) % 70) - 40);
+        break;
+    default:
+        break;
+    }
+}
+
+
+/**
+ * @brief 检查解析结果
+ * 
+ * @param type 数据类别
+ * @param string 字符串
+ * @param error 与参考结果不一致的次数
+ * @param ulp 与strtof相差1ulp的次数
+ * 
+ * @note 超出32位的整型和超出float范围的浮点数应返回溢出
+ */
+static void numberCheck(int type, char *string, unsigned long *error, unsigned long *ulp)
+{
+    char token[NUMBER_LENGTH];
+    size_t value;
+    int result;
+    union
+    {
+        unsigned int value;
+        float valueFloat;
+    } expect;
+
+    strcpy(token, string);
+    result = shellExtParseToken(NULL, token, SHELL_PARAM_NUMBER, &value);
+    switch (type)
+    {
+    case NUMBER_OVERFLOW:
+        if (result != -2)
+        {
+            (*error)++;
+        }
+        return;
+    case NUMBER_BIN:
+        expect.value = (unsigned int)strtoul(string + 2, NULL, 2);
+        break;
+    case NUMBER_FLOAT_SHORT:
+    case NUMBER_FLOAT_LONG:
+        expect.valueFloat = strtof(string, NULL);
+        if (expect.valueFloat > 3.402823466e+38f || expect.valueFloat < -3.402823466e+38f)
+        {
+            if (result != -2)
+            {
+                (*error)++;
+            }
+            return;
+        }
+        if (result == 0 && (unsigned int)value != expect.value
+            && ((unsigned int)value - expect.value + 1) <= 2)
+        {
+            (*ulp)++;
+            return;
+        }
+        break;
+    default:
+        expect.value = (unsigned int)strtoll(string, NULL, 0);
+        break;
+    }
+    if (result != 0 || (unsigned int)value != expect.value)
+    {
+        if (*error < 5)
+        {
+            fprintf(stderr, "mismatch: %s\n", string);
+        }
+        (*error)++;
+    }
+}
+
+
+/**
+ * @brief 数字解析基准测试
+ * 
+ * @note 用法: number [-n 每类数据数量]
+ *       对每类随机数据，检查解析结果与strtoll/strtof一致，并对比改写前后的解析耗时，
+ *       改写前的解析不支持指数和溢出检查，这些数据只用于对比耗时
+ */
+int main(int argc, char *argv[])
+{
+    unsigned int count = 100000;
+    unsigned long error;
+    unsigned long ulp;
+    unsigned long total = 0;
+    unsigned long long start;
+    unsigned long long ticksNew;
+    unsigned long long ticksLegacy;
+    volatile size_t sink = 0;
+    size_t value;
+    char (*input)[NUMBER_LENGTH];
+    char token[NUMBER_LENGTH];
+
+    if (argc > 2 && strcmp(argv[1], "-n") == 0)
+    {
+        count = (unsigned int)atoi(argv[2]);
+    }
+    input = malloc(sizeof(*input) * count);
+    if (!input)
+    {
+        return 1;
+    }
+
+    printf("%-12s %8s %8s %8s %14s %14s\n", "class", "inputs", "errors", "1ulp",
+           BENCH_UNIT "/new", BENCH_UNIT "/legacy");
+    for (int type = 0; type < NUMBER_CLASS; type++)
+    {
+        error = 0;
+        ulp = 0;
+        for (unsigned int i = 0; i < count; i++)
+        {
+            numberGenerate(type, input[i]);
+            numberCheck(type, input[i], &error, &ulp);
+        }
+
+        start = BENCH_TICK();
+        for (unsigned int i = 0; i < count; i++)
+        {
+            strcpy(token, input[i]);
+            shellExtParseToken(NULL, token, SHELL_PARAM_NUMBER, &value);
+            sink += value;
+        }
+        ticksNew = BENCH_TICK() - start;
+        start = BENCH_TICK();
+        for (unsigned int i = 0; i < count; i++)
+        {
+            strcpy(token, input[i]);
+            sink += legacyParseNumber(token);
+        }
+        ticksLegacy = BENCH_TICK() - start;
+
+        printf("%-12s %8u %8lu %8lu %14.1f %14.1f\n", numberClassName[type], count,
+               error, ulp, (double)ticksNew / count, (double)ticksLegacy / count);
+        total += error;
+    }
+    free(input);
+    return total ? 1 : 0;
+}
@@ -11,12 +11,17 @@
 
 #include "shell.h"
 #include "string.h"
-#include "stdio.h"
 #include "stdarg.h"
+#if SHELL_PRINT_STREAM == 0 && SHELL_PRINT_BUFFER > 0
+#include "stdio.h"
+#endif
 
 #if SHELL_AUTO_PRASE == 1
 #include "shell_ext.h"
 #endif
+#if SHELL_USING_TELNET == 1
+#include "shell_telnet.h"
+#endif
 
 /**
  * @brief shell提示信息文本索引
@@ -29,9 +34,18 @@ enum
     TEXT_PWD_ERROR,
     TEXT_FUN_LIST,
     TEXT_VAR_LIST,
+#if SHELL_USING_STATS == 1
+    TEXT_STATS_LIST,
+#endif /** SHELL_USING_STATS == 1 */
     TEXT_CMD_NONE,
     TEXT_CMD_TOO_LONG,
     TEXT_READ_NOT_DEF,
+#if SHELL_USING_PIPE == 1
+    TEXT_PIPE_ERROR,
+#endif /** SHELL_USING_PIPE == 1 */
+#if SHELL_USING_REDIRECT == 1
+    TEXT_SINK_ERROR,
+#endif /** SHELL_USING_REDIRECT == 1 */
 };
 
 /**
@@ -50,25 +64,123 @@ static const char *shellText[] =
     [TEXT_PWD_ERROR] = "\r\npassword confirm failed.\r\n",
     [TEXT_FUN_LIST]  = "\r\nCOMMAND LIST:\r\n\r\n",
     [TEXT_VAR_LIST]  = "\r\nVARIABLE LIST:\r\n\r\n",
+#if SHELL_USING_STATS == 1
+    [TEXT_STATS_LIST] = "\r\nCOMMAND STATS:\r\n\r\n"
+                        "command               count     min       max       avg\r\n",
+#endif /** SHELL_USING_STATS == 1 */
     [TEXT_CMD_NONE]  = "Command not found\r\n",
     [TEXT_CMD_TOO_LONG] = "\r\nWarnig: Command is too long\r\n",
     [TEXT_READ_NOT_DEF] = "error: shell.read must be defined\r\n",
+#if SHELL_USING_PIPE == 1
+    [TEXT_PIPE_ERROR] = "Pipe stage not supported\r\n",
+#endif /** SHELL_USING_PIPE == 1 */
+#if SHELL_USING_REDIRECT == 1
+    [TEXT_SINK_ERROR] = "Redirect sink not found\r\n",
+#endif /** SHELL_USING_REDIRECT == 1 */
 };
 
 
 static SHELL_TypeDef *shellList[SHELL_MAX_NUMBER] = {NULL};     /**< shell列表 */
+static SHELL_THREAD_LOCAL SHELL_TypeDef *shellCurrent = NULL; /**< 当前活动shell */
+#if SHELL_USING_STATS == 1
+static SHELL_CommandStatDef shellCommandStats[SHELL_STATS_NUMBER]; /**< 命令统计，按第一次执行的顺序存放 */
+#endif /** SHELL_USING_STATS == 1 */
+
+#if SHELL_COMMAND_INDEX_MAX > 0
+/**
+ * @brief shell命令索引
+ * 
+ * @note 按命令名排序的命令表下标，由使用同一命令表的shell共享
+ */
+static struct
+{
+    SHELL_CommandTypeDef *base;                                 /**< 索引对应的命令表基址 */
+    unsigned short number;                                      /**< 索引对应的命令数量 */
+    unsigned short index[SHELL_COMMAND_INDEX_MAX];              /**< 排序后的命令下标 */
+} shellCommandIndex;
+
+static void shellCommandIndexBuild(SHELL_TypeDef *shell);
+static void shellCommandIndexSort(SHELL_CommandTypeDef *base, unsigned short number);
+#endif /** SHELL_COMMAND_INDEX_MAX > 0 */
+
+#if SHELL_USING_REGISTRY == 1
+/**
+ * @brief shell共享命令注册表
+ * 
+ * @note 第一次调用`shellInit()`时解析，所有使用此命令表的shell共用，
+ *       运行时注册的命令在逻辑上排在命令表之后
+ */
+static struct
+{
+    SHELL_CommandTypeDef *commandBase;                          /**< 命令表基址 */
+    unsigned short commandNumber;                               /**< 命令表中的命令数量 */
+    unsigned char commandSorted;                                /**< 命令是否已按命令名排序 */
+    unsigned char ready;                                        /**< 注册表是否已解析 */
+#if SHELL_USING_VAR == 1
+    SHELL_VaribaleTypeDef *variableBase;                        /**< 变量表基址 */
+    unsigned short variableNumber;                              /**< 变量数量 */
+#endif /** SHELL_USING_VAR == 1 */
+    SHELL_CommandTypeDef *command[SHELL_REGISTRY_COMMAND_NUMBER]; /**< 运行时注册的命令 */
+    unsigned short number;                                      /**< 运行时注册的命令数量 */
+} shellRegistry;
+
+static void shellRegistryAttach(SHELL_TypeDef *shell);
+#endif /** SHELL_USING_REGISTRY == 1 */
 
 static void shellAdd(SHELL_TypeDef *shell);
-static void shellDisplayItem(SHELL_TypeDef *shell, unsigned short index);
+static void shellCommandTableUpdate(SHELL_TypeDef *shell);
+#if SHELL_KEY_TABLE_SIZE > 0
+static void shellKeyTableBuild(SHELL_TypeDef *shell);
+#endif
+static void shellDisplayItem(SHELL_TypeDef *shell, SHELL_CommandTypeDef *command);
+#if SHELL_PRINT_STREAM == 1
+static void shellWriteData(SHELL_TypeDef *shell, const char *data, unsigned short length);
+#endif /** SHELL_PRINT_STREAM == 1 */
 
+static unsigned char shellParseParam(SHELL_TypeDef *shell);
 static void shellEnter(SHELL_TypeDef *shell);
 static void shellTab(SHELL_TypeDef *shell);
 static void shellBackspace(SHELL_TypeDef *shell);
 static void shellAnsiStart(SHELL_TypeDef *shell);
+static void shellShowHelp(SHELL_TypeDef *shell, int argc, char *argv[]);
+#if SHELL_USING_MACHINE == 1
+static void shellMachineStart(SHELL_TypeDef *shell);
+#if SHELL_USING_ASYNC == 1
+static unsigned char shellMachineExecute(SHELL_TypeDef *shell, unsigned char paramCount,
+                                         int *returnValue);
+#endif /** SHELL_USING_ASYNC == 1 */
+#endif /** SHELL_USING_MACHINE == 1 */
+#if SHELL_USING_ASYNC == 1
+static void shellInputData(SHELL_TypeDef *shell, char data);
+#endif /** SHELL_USING_ASYNC == 1 */
+#if SHELL_HISTORY_SEARCH == 1
+static void shellSearchStart(SHELL_TypeDef *shell);
+#endif /** SHELL_HISTORY_SEARCH == 1 */
 
 #if SHELL_USING_VAR == 1
 static void shellDisplayVariable(SHELL_TypeDef *shell, char *var);
 void shellListVariables(void);
+void shellSetVariable(char *var, int value);
+#if SHELL_WATCH_NUMBER > 0
+int shellWatch(char *var);
+void shellWatchStart(int period, int binary);
+void shellWatchStop(void);
+#endif /** SHELL_WATCH_NUMBER > 0 */
+#if SHELL_VARIABLE_INDEX_MAX > 0
+/**
+ * @brief shell变量索引
+ * 
+ * @note 按变量名排序的变量表下标，由使用同一变量表的shell共享
+ */
+static struct
+{
+    SHELL_VaribaleTypeDef *base;                                /**< 索引对应的变量表基址 */
+    unsigned short number;                                      /**< 索引对应的变量数量 */
+    unsigned short index[SHELL_VARIABLE_INDEX_MAX];             /**< 排序后的变量下标 */
+} shellVariableIndex;
+
+static void shellVariableIndexBuild(SHELL_TypeDef *shell);
+#endif /** SHELL_VARIABLE_INDEX_MAX > 0 */
 #endif /** SHELL_USING_VAR == 1 */
 
 #if SHELL_USING_CMD_EXPORT != 1
@@ -85,7 +197,19 @@ const SHELL_CommandTypeDef shellDefaultCommandList[] =
 #if SHELL_USING_VAR == 1
     SHELL_CMD_ITEM(vars, shellListVariables, show vars),
     SHELL_CMD_ITEM_EX(setVar, shellSetVariable, set var, setVar $[var] [value]),
+#if SHELL_WATCH_NUMBER > 0
+    SHELL_CMD_ITEM_EX(watch, shellWatch, watch var, watch [var] --add var to watch list),
+    SHELL_CMD_ITEM_EX(watchStart, shellWatchStart, start watch, watchStart [period] [binary] --stream watched vars),
+    SHELL_CMD_ITEM(watchStop, shellWatchStop, stop watch),
+#endif /** SHELL_WATCH_NUMBER > 0 */
 #endif /** SHELL_USING_VAR == 1 */
+#if SHELL_AUTO_PRASE == 1
+    SHELL_CMD_ITEM_EX(source, shellSource, run script, source [address] [length] --run script stored at address),
+#endif /** SHELL_AUTO_PRASE == 1 */
+#if SHELL_USING_STATS == 1
+    SHELL_CMD_ITEM(stats, shellStats, show command stats),
+    SHELL_CMD_ITEM(statsClear, shellStatsClear, clear command stats),
+#endif /** SHELL_USING_STATS == 1 */
     SHELL_CMD_ITEM(cls, shellClear, clear command line),
 };
 
@@ -113,78 +237,75 @@ const SHELL_KeyFunctionDef shellDefaultKeyFunctionList[] =
     {SHELL_KEY_BACKSPACE,   shellBackspace},
     {SHELL_KEY_DELETE,      shellBackspace},
     {SHELL_KEY_ESC,         shellAnsiStart},
+#if SHELL_HISTORY_SEARCH == 1
+    {SHELL_KEY_CTRL_R,      shellSearchStart},
+#endif /** SHELL_HISTORY_SEARCH == 1 */
 };
 
 
 /**
- * @brief shell初始化
+ * @brief shell解析命令表和变量表
  * 
  * @param shell shell对象
+ * 
+ * @note 根据命令定义方式，使用命令导出形成的命令表或默认命令表
  */
-void shellInit(SHELL_TypeDef *shell)
+static void shellLoadTable(SHELL_TypeDef *shell)
 {
-    shell->length = 0;
-    shell->cursor = 0;
-    shell->historyCount = 0;
-    shell->historyFlag = 0;
-    shell->historyOffset = 0;
-    shell->status.inputMode = SHELL_IN_NORMAL;
-    shell->status.tabFlag = 0;
-    shell->command = SHELL_DEFAULT_COMMAND;
-    shell->isActive = 0;
-    shellAdd(shell);
-    
-#if SHELL_USING_AUTH == 1
-    shell->status.authFlag = 0;
-    shellDisplay(shell, shellText[TEXT_PWD_HINT]);
-#else
-    shellDisplay(shell, shellText[TEXT_INFO]);
-    shellDisplay(shell, shell->command);
-#endif     
-    
 #if SHELL_USING_CMD_EXPORT == 1
     #if defined(__CC_ARM) || (defined(__ARMCC_VERSION) && __ARMCC_VERSION >= 6000000)
+    #if SHELL_COMMAND_SORTED == 1
+        extern const unsigned int Image$$ER_SHELL_COMMAND$$Base;
+        extern const unsigned int Image$$ER_SHELL_COMMAND$$Limit;
+
+        shell->commandBase = (SHELL_CommandTypeDef *)(&Image$$ER_SHELL_COMMAND$$Base);
+        shell->commandNumber = ((size_t)(&Image$$ER_SHELL_COMMAND$$Limit)
+                                - (size_t)(&Image$$ER_SHELL_COMMAND$$Base))
+                                / sizeof(SHELL_CommandTypeDef);
+    #else
         extern const unsigned int shellCommand$$Base;
         extern const unsigned int shellCommand$$Limit;
-        extern const unsigned int shellVariable$$Base;
-        extern const unsigned int shellVariable$$Limit;
 
         shell->commandBase = (SHELL_CommandTypeDef *)(&shellCommand$$Base);
-        shell->commandNumber = ((unsigned int)(&shellCommand$$Limit)
-                                - (unsigned int)(&shellCommand$$Base))
+        shell->commandNumber = ((size_t)(&shellCommand$$Limit)
+                                - (size_t)(&shellCommand$$Base))
                                 / sizeof(SHELL_CommandTypeDef);
+    #endif /** SHELL_COMMAND_SORTED == 1 */
+        extern const unsigned int shellVariable$$Base;
+        extern const unsigned int shellVariable$$Limit;
         #if SHELL_USING_VAR == 1
             shell->variableBase = (SHELL_VaribaleTypeDef *)(&shellVariable$$Base);
-            shell->variableNumber = ((unsigned int)(&shellVariable$$Limit)
-                                    - (unsigned int)(&shellVariable$$Base))
+            shell->variableNumber = ((size_t)(&shellVariable$$Limit)
+                                    - (size_t)(&shellVariable$$Base))
                                     / sizeof(SHELL_VaribaleTypeDef);
         #endif /** SHELL_USING_VAR == 1 */
 
     #elif defined(__ICCARM__)
         shell->commandBase = (SHELL_CommandTypeDef *)(__section_begin("shellCommand"));
-        shell->commandNumber = ((unsigned int)(__section_end("shellCommand"))
-                                - (unsigned int)(__section_begin("shellCommand")))
+        shell->commandNumber = ((size_t)(__section_end("shellCommand"))
+                                - (size_t)(__section_begin("shellCommand")))
                                 / sizeof(SHELL_CommandTypeDef);
         #if SHELL_USING_VAR == 1
             shell->variableBase = (SHELL_VaribaleTypeDef *)(__section_begin("shellVariable"));
-            shell->variableNumber = ((unsigned int)(__section_end("shellVariable"))
-                                    - (unsigned int)(__section_begin("shellVariable")))
+            shell->variableNumber = ((size_t)(__section_end("shellVariable"))
+                                    - (size_t)(__section_begin("shellVariable")))
                                     / sizeof(SHELL_VaribaleTypeDef);
         #endif /** SHELL_USING_VAR == 1 */
     #elif defined(__GNUC__)
-        extern const unsigned int _shell_command_start;
-        extern const unsigned int _shell_command_end;
+        /* 段符号声明为不定长数组，编译器不会按单个int的大小检查表的访问 */
+        extern const unsigned int _shell_command_start[];
+        extern const unsigned int _shell_command_end[];
         
-        shell->commandBase = (SHELL_CommandTypeDef *)(&_shell_command_start);
-        shell->commandNumber = ((unsigned int)(&_shell_command_end)
-                                - (unsigned int)(&_shell_command_start))
+        shell->commandBase = (SHELL_CommandTypeDef *)(_shell_command_start);
+        shell->commandNumber = ((size_t)(_shell_command_end)
+                                - (size_t)(_shell_command_start))
                                 / sizeof(SHELL_CommandTypeDef);
         #if SHELL_USING_VAR == 1
-            extern const unsigned int _shell_variable_start;
-            extern const unsigned int _shell_variable_end;
-            shell->variableBase = (SHELL_VaribaleTypeDef *)(&_shell_variable_start);
-            shell->variableNumber = ((unsigned int)(&_shell_variable_end)
-                                    - (unsigned int)(&_shell_variable_start))
+            extern const unsigned int _shell_variable_start[];
+            extern const unsigned int _shell_variable_end[];
+            shell->variableBase = (SHELL_VaribaleTypeDef *)(_shell_variable_start);
+            shell->variableNumber = ((size_t)(_shell_variable_end)
+                                    - (size_t)(_shell_variable_start))
                                     / sizeof(SHELL_VaribaleTypeDef);
         #endif /** SHELL_USING_VAR == 1 */
     #else
@@ -201,6 +322,184 @@ void shellInit(SHELL_TypeDef *shell)
 }
 
 
+/**
+ * @brief shell显示初始化信息
+ * 
+ * @param shell shell对象
+ * 
+ * @note 使用密码时显示密码提示，否则显示shell信息和提示符
+ */
+static void shellDisplayStart(SHELL_TypeDef *shell)
+{
+#if SHELL_USING_AUTH == 1
+    shellDisplay(shell, shellText[TEXT_PWD_HINT]);
+#else
+    shellDisplay(shell, shellText[TEXT_INFO]);
+    shellDisplay(shell, shell->command);
+#endif
+}
+
+
+/**
+ * @brief shell初始化
+ * 
+ * @param shell shell对象
+ */
+void shellInit(SHELL_TypeDef *shell)
+{
+    shell->length = 0;
+    shell->cursor = 0;
+    shell->historyCount = 0;
+#if SHELL_HISTORY_BUFFER_SIZE > 0
+    shell->historyLength = 0;
+#else
+    shell->historyFlag = 0;
+#endif /** SHELL_HISTORY_BUFFER_SIZE > 0 */
+    shell->historyOffset = 0;
+    shell->status.inputMode = SHELL_IN_NORMAL;
+    shell->status.tabFlag = 0;
+    shell->status.machineMode = 0;
+    shell->status.searchMode = 0;
+#if SHELL_USING_PIPE == 1
+    shell->pipe.number = 0;
+#endif /** SHELL_USING_PIPE == 1 */
+#if SHELL_USING_REDIRECT == 1
+    shell->sink = NULL;
+    shell->sinkBase = NULL;
+    shell->sinkNumber = 0;
+#endif /** SHELL_USING_REDIRECT == 1 */
+#if SHELL_USING_VAR == 1 && SHELL_WATCH_NUMBER > 0
+    shell->watch.number = 0;
+    shell->watch.active = 0;
+#endif /** SHELL_USING_VAR == 1 && SHELL_WATCH_NUMBER > 0 */
+#if SHELL_USING_ASYNC == 1
+    shell->async.busy = 0;
+    shell->async.pending = 0;
+    shell->async.cancel = 0;
+#if SHELL_USING_MACHINE == 1
+    shell->async.request = 0;
+    shell->async.frame.state = 0;
+#endif /** SHELL_USING_MACHINE == 1 */
+    shell->async.head = 0;
+    shell->async.tail = 0;
+    shell->async.write = 0;
+#endif /** SHELL_USING_ASYNC == 1 */
+#if SHELL_TX_BUFFER_SIZE > 0
+    shell->tx.head = 0;
+    shell->tx.tail = 0;
+    shell->tx.sending = 0;
+#endif
+    shell->command = SHELL_DEFAULT_COMMAND;
+    shell->isActive = 0;
+#if SHELL_KEY_TABLE_SIZE > 0
+    shellKeyTableBuild(shell);
+#endif
+    shellAdd(shell);
+#if SHELL_USING_AUTH == 1
+    shell->status.authFlag = 0;
+#endif
+#if SHELL_INIT_DEFERRED == 1
+    shell->status.startPending = 1;
+#else
+    shellDisplayStart(shell);
+#endif /** SHELL_INIT_DEFERRED == 1 */
+
+#if SHELL_USING_REGISTRY == 1
+    shellRegistryAttach(shell);
+#else
+    shellLoadTable(shell);
+    shellCommandTableUpdate(shell);
+#if SHELL_USING_VAR == 1 && SHELL_VARIABLE_INDEX_MAX > 0
+    shellVariableIndexBuild(shell);
+#endif /** SHELL_USING_VAR == 1 && SHELL_VARIABLE_INDEX_MAX > 0 */
+#endif /** SHELL_USING_REGISTRY == 1 */
+}
+
+
+#if SHELL_USING_REGISTRY == 1
+/**
+ * @brief shell同步共享命令注册表
+ * 
+ * @param shell shell对象
+ * 
+ * @note 使用共享命令表的shell更新命令数量和排序状态，使运行时注册的命令生效
+ * @note 需要在`SHELL_LIST_LOCK()`内调用，查找命令时与按命令名顺序的访问在同一次加锁中完成，
+ *       避免`shellRegisterCommand()`移动命令索引时读到不一致的索引
+ */
+static void shellRegistrySync(SHELL_TypeDef *shell)
+{
+    if (shell->commandBase == shellRegistry.commandBase)
+    {
+        shell->commandNumber = shellRegistry.commandNumber + shellRegistry.number;
+        shell->status.commandSorted = shellRegistry.commandSorted;
+    }
+}
+
+
+/**
+ * @brief shell使用共享命令注册表
+ * 
+ * @param shell shell对象
+ * 
+ * @note 注册表在第一次调用时解析，之后的shell直接使用解析结果
+ */
+static void shellRegistryAttach(SHELL_TypeDef *shell)
+{
+    SHELL_LIST_LOCK();
+    if (!shellRegistry.ready)
+    {
+        shellLoadTable(shell);
+        shellCommandTableUpdate(shell);
+    #if SHELL_USING_VAR == 1
+    #if SHELL_VARIABLE_INDEX_MAX > 0
+        shellVariableIndexBuild(shell);
+    #endif /** SHELL_VARIABLE_INDEX_MAX > 0 */
+        shellRegistry.variableBase = shell->variableBase;
+        shellRegistry.variableNumber = shell->variableNumber;
+    #endif /** SHELL_USING_VAR == 1 */
+        shellRegistry.commandBase = shell->commandBase;
+        shellRegistry.commandNumber = shell->commandNumber;
+        shellRegistry.commandSorted = shell->status.commandSorted;
+        shellRegistry.number = 0;
+        shellRegistry.ready = 1;
+    }
+    shell->commandBase = shellRegistry.commandBase;
+#if SHELL_USING_VAR == 1
+    shell->variableBase = shellRegistry.variableBase;
+    shell->variableNumber = shellRegistry.variableNumber;
+#endif /** SHELL_USING_VAR == 1 */
+    shellRegistrySync(shell);
+    SHELL_LIST_UNLOCK();
+}
+#endif /** SHELL_USING_REGISTRY == 1 */
+
+
+#if SHELL_USING_REGISTRY == 1 || SHELL_INIT_DEFERRED == 1
+/**
+ * @brief shell处理输入前的准备
+ * 
+ * @param shell shell对象
+ * 
+ * @note 同步共享命令注册表，显示延迟的初始化信息
+ */
+static void shellInputPrepare(SHELL_TypeDef *shell)
+{
+#if SHELL_USING_REGISTRY == 1
+    SHELL_LIST_LOCK();
+    shellRegistrySync(shell);
+    SHELL_LIST_UNLOCK();
+#endif /** SHELL_USING_REGISTRY == 1 */
+#if SHELL_INIT_DEFERRED == 1
+    if (shell->status.startPending)
+    {
+        shell->status.startPending = 0;
+        shellDisplayStart(shell);
+    }
+#endif /** SHELL_INIT_DEFERRED == 1 */
+}
+#endif /** SHELL_USING_REGISTRY == 1 || SHELL_INIT_DEFERRED == 1 */
+
+
 #if SHELL_USING_CMD_EXPORT != 1
 /**
  * @brief shell设置命令表
@@ -216,6 +515,7 @@ void shellSetCommandList(SHELL_TypeDef *shell, SHELL_CommandTypeDef *base, unsig
 {
     shell->commandBase = base;
     shell->commandNumber = size;
+    shellCommandTableUpdate(shell);
 }
 
 
@@ -234,6 +534,9 @@ void shellSetVariableList(SHELL_TypeDef *shell, SHELL_VaribaleTypeDef *base, uns
 {
     shell->variableBase = base;
     shell->variableNumber = size;
+#if SHELL_VARIABLE_INDEX_MAX > 0
+    shellVariableIndexBuild(shell);
+#endif /** SHELL_VARIABLE_INDEX_MAX > 0 */
 }
 #endif /** SHELL_USING_VAR == 1 */
 #endif /** SHELL_USING_CMD_EXPORT != 1 */
@@ -248,937 +551,4737 @@ void shellSetVariableList(SHELL_TypeDef *shell, SHELL_VaribaleTypeDef *base, uns
  */
 void shellSetKeyFuncList(SHELL_TypeDef *shell, SHELL_KeyFunctionDef *base, unsigned short size)
 {
-    shell->keyFuncBase = (int)base;
+    shell->keyFuncBase = base;
     shell->keyFuncNumber = size;
+#if SHELL_KEY_TABLE_SIZE > 0
+    shellKeyTableBuild(shell);
+#endif
 }
 
 
+#if SHELL_HISTORY_ATTACH == 1
 /**
- * @brief 添加shell到shell列表
+ * @brief shell设置历史记录缓冲
  * 
  * @param shell shell对象
+ * @param buffer 历史记录缓冲，大小为`SHELL_HISTORY_BUFFER_SIZE`，为NULL时不记录历史
+ * 
+ * @note 设置后原有的历史记录被清空，一个缓冲同一时间只能由一个shell使用
  */
-static void shellAdd(SHELL_TypeDef *shell)
+void shellSetHistoryBuffer(SHELL_TypeDef *shell, char *buffer)
 {
-    for (short i = 0; i < SHELL_MAX_NUMBER; i++)
-    {
-        if (shellList[i] == NULL)
-        {
-            shellList[i] = shell;
-            return;
-        }
-    }
+    shell->history = buffer;
+    shell->historyLength = 0;
+    shell->historyCount = 0;
+    shell->historyOffset = 0;
 }
+#endif /** SHELL_HISTORY_ATTACH == 1 */
 
 
+#if SHELL_USING_REDIRECT == 1
 /**
- * @brief 获取当前活动shell
+ * @brief shell设置输出目标表
+ * 
+ * @param shell shell对象
+ * @param base 输出目标表基址
+ * @param size 输出目标数量
  * 
- * @return SHELL_TypeDef* 当前活动shell对象
+ * @note 表中的输出目标可以通过`command > [name]`使用
  */
-SHELL_TypeDef *shellGetCurrent(void)
+void shellSetSinkList(SHELL_TypeDef *shell, SHELL_SinkTypeDef *base, unsigned short size)
 {
-    for (short i = 0; i < SHELL_MAX_NUMBER; i++)
-    {
-        if (shellList[i] != NULL && shellList[i]->isActive == 1)
-        {
-            return shellList[i];
-        }
-    }
-    return NULL;
+    shell->sinkBase = base;
+    shell->sinkNumber = size;
 }
 
 
-#if SHELL_PRINT_BUFFER > 0
 /**
- * @brief shell格式化输出
+ * @brief shell重定向输出
  * 
  * @param shell shell对象
- * @param fmt 格式化字符串
- * @param ... 参数
+ * @param sink 输出目标，为NULL时恢复正常输出
+ * @return SHELL_SinkTypeDef* 之前的输出目标
+ * 
+ * @note 重定向对之后的所有输出生效，包括脚本执行的输出，可以使用返回值恢复之前的输出目标
  */
-void shellPrint(SHELL_TypeDef *shell, char *fmt, ...)
+SHELL_SinkTypeDef *shellRedirect(SHELL_TypeDef *shell, SHELL_SinkTypeDef *sink)
 {
-    char buffer[SHELL_PRINT_BUFFER];
-    va_list vargs;
-
-    if (!shell)
-    {
-        return;
-    }
-
-    va_start(vargs, fmt);
-    vsnprintf(buffer, SHELL_PRINT_BUFFER - 1, fmt, vargs);
-    va_end(vargs);
-    
-    shellDisplay(shell, buffer);
+    SHELL_SinkTypeDef *last = shell->sink;
+    shell->sink = sink;
+    return last;
 }
-#endif
 
 
 /**
- * @brief shell显示字符串
+ * @brief shell内存输出目标写数据
  * 
- * @param shell shell对象
- * @param string 字符串
- * @return unsigned short 字符串长度
+ * @param sink 输出目标，参数为`SHELL_SinkBufferDef`
+ * @param data 数据
+ * @param length 数据长度
+ * 
+ * @note 缓冲写满后丢弃后续数据，清空缓冲只需要将`length`置0
  */
-unsigned short shellDisplay(SHELL_TypeDef *shell, const char *string)
+void shellSinkBufferWrite(SHELL_SinkTypeDef *sink, const char *data, unsigned short length)
 {
-    unsigned short count = 0;
-    if (shell->write == NULL)
+    SHELL_SinkBufferDef *buffer = (SHELL_SinkBufferDef *)sink->param;
+
+    if (buffer->length + 1 >= buffer->size)
     {
-        return 0;
+        return;
     }
-    while(*string)
+    if (length > buffer->size - buffer->length - 1)
     {
-        shell->write(*string++);
-        count ++;
+        length = buffer->size - buffer->length - 1;
     }
-    return count;
+    memcpy(buffer->buffer + buffer->length, data, length);
+    buffer->length += length;
+    buffer->buffer[buffer->length] = 0;
 }
 
 
 /**
- * @brief shell显示字符
+ * @brief shell解析输出重定向
  * 
- * @param shell shel对象
- * @param data 字符
+ * @param shell shell对象
+ * @param paramCount 参数个数，解析后为重定向前的参数个数
+ * @return signed char 0 解析成功 -1 输出目标不存在
+ * 
+ * @note 重定向为命令最后的`> [name]`，解析成功后设置当前输出目标
  */
-static void shellDisplayByte(SHELL_TypeDef *shell, char data)
+static signed char shellRedirectParse(SHELL_TypeDef *shell, unsigned char *paramCount)
 {
-    if (shell->write == NULL)
+    if (*paramCount < 3 || strcmp(shell->param[*paramCount - 2], ">") != 0)
     {
-        return;
+        return 0;
+    }
+    for (unsigned short i = 0; i < shell->sinkNumber; i++)
+    {
+        if (strcmp(shell->sinkBase[i].name, shell->param[*paramCount - 1]) == 0)
+        {
+            shell->sink = &(shell->sinkBase[i]);
+            *paramCount -= 2;
+            return 0;
+        }
     }
-    shell->write(data);
+    return -1;
 }
+#endif /** SHELL_USING_REDIRECT == 1 */
 
 
-#if SHELL_USING_VAR == 1 || SHELL_DISPLAY_RETURN == 1
+#if SHELL_KEY_TABLE_SIZE > 0
 /**
- * @brief shell显示值
+ * @brief shell建立按键响应查找表
  * 
  * @param shell shell对象
- * @param value 值
+ * 
+ * @note 用户按键响应优先于默认按键响应，同一键值只取第一个定义
  */
-static void shellDisplayValue(SHELL_TypeDef *shell, int value)
+static void shellKeyTableBuild(SHELL_TypeDef *shell)
 {
-    char str[11] = "0000000000";
-    unsigned int v = value;
-    char i = 10;
-    char tmp;
+    SHELL_KeyFunctionDef *base = shell->keyFuncBase;
 
-    if (value < 0)
-    {
-        shellDisplay(shell, "-");
-        v = -v;
-    }
-    while (v)
-    {
-        str[--i] = v % 10 + 48;
-        v /= 10;
-    }
-    shellDisplay(shell, str + i - (value == 0));
-    v = value;
-    if (value < 0)
+    memset(shell->keyTable, 0, sizeof(shell->keyTable));
+    for (short i = sizeof(shellDefaultKeyFunctionList) / sizeof(SHELL_KeyFunctionDef) - 1;
+         i >= 0; i--)
     {
-        v = (unsigned int)value;
+        if (shellDefaultKeyFunctionList[i].keyCode < SHELL_KEY_TABLE_SIZE)
+        {
+            shell->keyTable[shellDefaultKeyFunctionList[i].keyCode]
+                = &shellDefaultKeyFunctionList[i];
+        }
     }
-    i = 8;
-    str[8] = 0;
-    while (v)
+    for (unsigned short i = shell->keyFuncNumber; i > 0; i--)
     {
-        tmp = v & 0x0000000F;
-        str[--i] = (tmp > 9) ? (tmp + 87) : (tmp + 48);
-        v >>= 4;
+        if (base[i - 1].keyCode < SHELL_KEY_TABLE_SIZE)
+        {
+            shell->keyTable[base[i - 1].keyCode] = &base[i - 1];
+        }
     }
-    shellDisplay(shell, ", 0x");
-    shellDisplay(shell, str);
-    shellDisplay(shell, "\r\n");
-}
-#endif
-
-
-#if SHELL_DISPLAY_RETURN == 1
-/**
- * @brief shell显示函数调用返回值
- * 
- * @param shell shel对象
- * @param value 值
- */
-static void shellDisplayReturn(SHELL_TypeDef *shell, int value)
-{
-    shellDisplay(shell, "Return: ");
-    shellDisplayValue(shell, value);
 }
-#endif /** SHELL_DISPLAY_RETURN == 1 */
+#endif /** SHELL_KEY_TABLE_SIZE > 0 */
 
 
 /**
- * @brief shell字符串复制
+ * @brief shell查找默认按键响应
  * 
- * @param dest 目标字符串
- * @param src 源字符串
- * @return unsigned short 字符串长度
+ * @param data 键值
+ * @return const SHELL_KeyFunctionDef* 按键响应，未找到返回NULL
  */
-static unsigned short shellStringCopy(char *dest, char* src)
+static const SHELL_KeyFunctionDef *shellSeekDefaultKey(char data)
 {
-    unsigned short count = 0;
-    while (*(src + count))
+    for (short i = 0; 
+        i < sizeof(shellDefaultKeyFunctionList) / sizeof(SHELL_KeyFunctionDef);
+        i++)
     {
-        *(dest + count) = *(src + count);
-        count++;
+        if (shellDefaultKeyFunctionList[i].keyCode == (unsigned char)data)
+        {
+            return &shellDefaultKeyFunctionList[i];
+        }
     }
-    *(dest + count) = 0;
-    return count;
+    return NULL;
 }
 
 
 /**
- * @brief shell字符串比较
+ * @brief shell查找按键响应
  * 
- * @param dest 目标字符串
- * @param src 源字符串
- * @return unsigned short 匹配长度
+ * @param shell shell对象
+ * @param data 键值
+ * @return const SHELL_KeyFunctionDef* 按键响应，未找到返回NULL
+ * 
+ * @note 使用密码且未验证时，用户定义的按键响应无效
  */
-static unsigned short shellStringCompare(char* dest, char *src)
+static const SHELL_KeyFunctionDef *shellSeekKey(SHELL_TypeDef *shell, char data)
 {
-    unsigned short match = 0;
-    unsigned short i = 0;
+    SHELL_KeyFunctionDef *base = shell->keyFuncBase;
 
-    while (*(dest +i) && *(src + i))
+#if SHELL_KEY_TABLE_SIZE > 0
+    if ((unsigned char)data < SHELL_KEY_TABLE_SIZE)
     {
-        if (*(dest + i) != *(src +i))
+        const SHELL_KeyFunctionDef *key = shell->keyTable[(unsigned char)data];
+    #if SHELL_USING_AUTH == 1
+        if (key && !shell->status.authFlag
+            && (key < shellDefaultKeyFunctionList
+                || key >= shellDefaultKeyFunctionList
+                          + sizeof(shellDefaultKeyFunctionList) / sizeof(SHELL_KeyFunctionDef)))
         {
-            break;
+            return shellSeekDefaultKey(data);
         }
-        match ++;
-        i++;
+    #endif
+        return key;
     }
-    return match;
+#endif /** SHELL_KEY_TABLE_SIZE > 0 */
+#if SHELL_USING_AUTH == 1
+    if (shell->status.authFlag)
+    {
+#endif
+        for (unsigned short i = 0; i < shell->keyFuncNumber; i++)
+        {
+            if (base[i].keyCode == (unsigned char)data)
+            {
+                return &base[i];
+            }
+        }
+#if SHELL_USING_AUTH == 1
+    }
+#endif
+    return shellSeekDefaultKey(data);
 }
 
 
 /**
- * @brief shell删除
+ * @brief 添加shell到shell列表
  * 
  * @param shell shell对象
- * @param length 删除的长度
  */
-static void shellDelete(SHELL_TypeDef *shell, unsigned short length)
+static void shellAdd(SHELL_TypeDef *shell)
 {
-    while (length--)
+    short free = -1;
+
+    SHELL_LIST_LOCK();
+    for (short i = 0; i < SHELL_MAX_NUMBER; i++)
+    {
+        if (shellList[i] == shell)
+        {
+            free = -1;
+            break;
+        }
+        if (shellList[i] == NULL && free < 0)
+        {
+            free = i;
+        }
+    }
+    if (free >= 0)
     {
-        shellDisplay(shell, "\b \b");
+        shellList[free] = shell;
     }
+    SHELL_LIST_UNLOCK();
 }
 
 
 /**
- * @brief shell清除输入
+ * @brief 从shell列表移除shell
  * 
  * @param shell shell对象
+ * 
+ * @note shell对象不再使用(如telnet会话关闭)时调用，移除后shell列表的位置可以给其他shell使用
  */
-static void shellClearLine(SHELL_TypeDef *shell)
+void shellRemove(SHELL_TypeDef *shell)
 {
-    for (short i = shell->length - shell->cursor; i > 0; i--)
+    SHELL_LIST_LOCK();
+    for (short i = 0; i < SHELL_MAX_NUMBER; i++)
     {
-        shellDisplayByte(shell, ' ');
+        if (shellList[i] == shell)
+        {
+            shellList[i] = NULL;
+            break;
+        }
+    }
+    SHELL_LIST_UNLOCK();
+    if (shellCurrent == shell)
+    {
+        shellCurrent = NULL;
     }
-    shellDelete(shell, shell->length);
 }
 
 
 /**
- * @brief shell历史记录添加
+ * @brief 设置当前活动shell
  * 
  * @param shell shell对象
+ * @return SHELL_TypeDef* 之前的活动shell对象，用于恢复
+ * 
+ * @note 当前shell指针由`SHELL_THREAD_LOCAL`修饰，定义为线程局部存储时，各任务互不影响
  */
-static void shellHistoryAdd(SHELL_TypeDef *shell)
+static SHELL_TypeDef *shellSetCurrent(SHELL_TypeDef *shell)
 {
-    shell->historyOffset = 0;
-    if (strcmp(shell->history[shell->historyFlag - 1], shell->buffer) == 0)
-    {
-        return;
-    }
-    if (shellStringCopy(shell->history[shell->historyFlag], shell->buffer) != 0)
+    SHELL_TypeDef *last = shellCurrent;
+
+    if (last)
     {
-        shell->historyFlag++;
+        last->isActive = 0;
     }
-    if (++shell->historyCount > SHELL_HISTORY_MAX_NUMBER)
+    if (shell)
     {
-        shell->historyCount = SHELL_HISTORY_MAX_NUMBER;
+        shell->isActive = 1;
     }
-    if (shell->historyFlag >= SHELL_HISTORY_MAX_NUMBER)
+    shellCurrent = shell;
+    return last;
+}
+
+
+/**
+ * @brief 获取当前活动shell
+ * 
+ * @return SHELL_TypeDef* 当前活动shell对象，即调用者所在任务中正在执行命令的shell
+ */
+SHELL_TypeDef *shellGetCurrent(void)
+{
+    return shellCurrent;
+}
+
+
+/**
+ * @brief shell获取命令
+ * 
+ * @param base 命令表基址
+ * @param index 命令下标
+ * @return SHELL_CommandTypeDef* 命令
+ * 
+ * @note 使用共享命令注册表时，超出命令表的下标对应运行时注册的命令
+ */
+static SHELL_CommandTypeDef *shellCommandAt(SHELL_CommandTypeDef *base, unsigned short index)
+{
+#if SHELL_USING_REGISTRY == 1
+    if (base == shellRegistry.commandBase && index >= shellRegistry.commandNumber)
     {
-        shell->historyFlag = 0;
+        return shellRegistry.command[index - shellRegistry.commandNumber];
     }
+#endif /** SHELL_USING_REGISTRY == 1 */
+    return base + index;
 }
 
 
+#if SHELL_COMMAND_INDEX_MAX > 0
 /**
- * @brief shell历史记录查找
+ * @brief shell命令排序比较
+ * 
+ * @param base 命令表基址
+ * @param a 命令下标
+ * @param b 命令下标
+ * @return int 比较结果，命令名相同时按下标比较
+ */
+static int shellCommandIndexCompare(SHELL_CommandTypeDef *base,
+                                    unsigned short a, unsigned short b)
+{
+    int result = strcmp(shellCommandAt(base, a)->name, shellCommandAt(base, b)->name);
+    return (result != 0) ? result : (int)a - (int)b;
+}
+
+
+/**
+ * @brief shell建立命令索引
  * 
  * @param shell shell对象
- * @param dir 查找方向
+ * 
+ * @note 索引被其他shell使用时不会重建，此时当前shell使用顺序查找
  */
-static void shellHistory(SHELL_TypeDef *shell, unsigned char dir)
+static void shellCommandIndexBuild(SHELL_TypeDef *shell)
 {
-#if SHELL_USING_AUTH == 1
-    if (!shell->status.authFlag)
-    {
-        return;
-    }
-#endif
-    if (dir == 0)
-    {
-        if (shell->historyOffset--
-            <= -((shell->historyCount > shell->historyFlag)
-            ? shell->historyCount : shell->historyFlag))
-        {
-            shell->historyOffset = -((shell->historyCount > shell->historyFlag)
-                                   ? shell->historyCount : shell->historyFlag);
-        }
-    }
-    else if (dir == 1)
-    {
-        if (++shell->historyOffset > 0)
-        {
-            shell->historyOffset = 0;
-            return;
-        }
-    }
-    else
+    SHELL_CommandTypeDef *base = shell->commandBase;
+    unsigned short number = shell->commandNumber;
+
+    if (shell->status.commandSorted
+        || (shellCommandIndex.base == base && shellCommandIndex.number == number))
     {
         return;
     }
-    shellClearLine(shell);
-    if (shell->historyOffset == 0)
-    {
-        shell->cursor = shell->length = 0;
-    }
-    else
+    if (shellCommandIndex.base != NULL)
     {
-        if ((shell->length = shellStringCopy(shell->buffer,
-                shell->history[(shell->historyFlag + SHELL_HISTORY_MAX_NUMBER
-                + shell->historyOffset) % SHELL_HISTORY_MAX_NUMBER])) == 0)
+        for (short i = 0; i < SHELL_MAX_NUMBER; i++)
         {
-            return;
+            if (shellList[i] != NULL && shellList[i] != shell
+                && shellList[i]->commandBase == shellCommandIndex.base
+                && shellList[i]->commandNumber == shellCommandIndex.number)
+            {
+                return;
+            }
         }
-        shell->cursor = shell->length;
-        shellDisplay(shell, shell->buffer);
     }
+    shellCommandIndexSort(base, number);
 }
 
 
 /**
- * @brief shell回车输入处理
+ * @brief shell排序命令索引
  * 
- * @param shell shell对象
+ * @param base 命令表基址
+ * @param number 命令数量
+ * 
+ * @note 命令数量超过`SHELL_COMMAND_INDEX_MAX`时不建立索引
  */
-static void shellEnter(SHELL_TypeDef *shell)
+static void shellCommandIndexSort(SHELL_CommandTypeDef *base, unsigned short number)
 {
-    unsigned char paramCount = 0;
-    unsigned char quotes = 0;
-    unsigned char record = 1;
-    SHELL_CommandTypeDef *base;
-    unsigned char runFlag = 0;
-    int returnValue;
-    (void) returnValue;
+    unsigned short gap;
+    unsigned short tmp;
+    unsigned short j;
 
-#if SHELL_USING_AUTH == 1
-    if(shell->status.authFlag == 0)
+    shellCommandIndex.base = NULL;
+    if (base == NULL || number > SHELL_COMMAND_INDEX_MAX)
     {
-        if((shell->length != strlen(SHELL_USER_PASSWORD)) 
-            ||(strncmp(shell->buffer, SHELL_USER_PASSWORD, strlen(SHELL_USER_PASSWORD)) != 0))
-        {
-            shellDisplay(shell, shellText[TEXT_PWD_ERROR]);
-            shellDisplay(shell, shellText[TEXT_PWD_HINT]);
-        }
-        else
-        {
-            shell->status.authFlag = 1;
-            shellDisplay(shell, shellText[TEXT_PWD_RIGHT]);
-            shellDisplay(shell, shellText[TEXT_INFO]);
-            shellDisplay(shell, shell->command);
-        }
-
-        shell->length = 0; 
-        shell->cursor = 0;
         return;
     }
-#endif
-    
-    if (shell->length == 0)
+
+    for (unsigned short i = 0; i < number; i++)
     {
-        shellDisplay(shell, shell->command);
-        return;
+        shellCommandIndex.index[i] = i;
     }
-    
-    *(shell->buffer + shell->length++) = 0;
-    shellHistoryAdd(shell);
-
-    for (unsigned short i = 0; i < shell->length; i++)
+    for (gap = number / 2; gap > 0; gap /= 2)
     {
-        if ((quotes != 0 ||
-            (*(shell->buffer + i) != ' ' &&
-            *(shell->buffer + i) != '\t' &&
-            *(shell->buffer + i) != ',')) &&
-            *(shell->buffer + i) != 0)
+        for (unsigned short i = gap; i < number; i++)
         {
-            if (*(shell->buffer + i) == '\"')
-            {
-                quotes = quotes ? 0 : 1;
-            #if SHELL_AUTO_PRASE == 0
-                *(shell->buffer + i) = 0;
-                continue;
-            #endif
-            }
-            if (record == 1)
+            tmp = shellCommandIndex.index[i];
+            for (j = i; j >= gap
+                 && shellCommandIndexCompare(base, shellCommandIndex.index[j - gap], tmp) > 0;
+                 j -= gap)
             {
-                shell->param[paramCount++] = shell->buffer + i;
-                record = 0;
+                shellCommandIndex.index[j] = shellCommandIndex.index[j - gap];
             }
-            if (*(shell->buffer + i) == '\\' &&
-                *(shell->buffer + i) != 0)
-            {
-                i++;
-            }
-        }
-        else
-        {
-            *(shell->buffer + i) = 0;
-            record = 1;
+            shellCommandIndex.index[j] = tmp;
         }
     }
-    shell->length = 0;
-    shell->cursor = 0;
-    if (paramCount == 0)
-    {
-        shellDisplay(shell, shell->command);
-        return;
-    }
+    shellCommandIndex.base = base;
+    shellCommandIndex.number = number;
+}
+#endif /** SHELL_COMMAND_INDEX_MAX > 0 */
 
-    shellDisplay(shell, "\r\n");
-    base = shell->commandBase;
-    if (strcmp((const char *)shell->param[0], "help") == 0)
-    {
-        shell->isActive = 1;
-        shellHelp(paramCount, shell->param);
-        shell->isActive = 0;
-        shellDisplay(shell, shell->command);
-        return;
-    }
-#if SHELL_USING_VAR == 1
-    if (shell->param[0][0] == '$')
-    {
-        shellDisplayVariable(shell, shell->param[0]);
-        shellDisplay(shell, shell->command);
-        return;
-    }
-#endif /** SHELL_USING_VAR == 1 */
-    for (unsigned char i = 0; i < shell->commandNumber; i++)
+
+/**
+ * @brief shell命令表更新
+ * 
+ * @param shell shell对象
+ * 
+ * @note 命令表改变后调用，检查命令表是否已排序，未排序时建立命令索引
+ */
+static void shellCommandTableUpdate(SHELL_TypeDef *shell)
+{
+    shell->status.commandSorted = 0;
+#if SHELL_COMMAND_SORTED == 1
+    shell->status.commandSorted = 1;
+    for (unsigned short i = 1; i < shell->commandNumber; i++)
     {
-        if (strcmp((const char *)shell->param[0], (base + i)->name) == 0)
+        if (strcmp((shell->commandBase + i - 1)->name, (shell->commandBase + i)->name) > 0)
         {
-            runFlag = 1;
-            shell->isActive = 1;
-        #if SHELL_AUTO_PRASE == 0
-            returnValue = (base + i)->function(paramCount, shell->param);
-        #else
-            returnValue = shellExtRun((base + i)->function, paramCount, shell->param);
-        #endif /** SHELL_AUTO_PRASE == 0 */
-            shell->isActive = 0;
-        #if SHELL_DISPLAY_RETURN == 1
-            shellDisplayReturn(shell, returnValue);
-        #endif /** SHELL_DISPLAY_RETURN == 1 */
+            shell->status.commandSorted = 0;
             break;
         }
     }
-    if (runFlag == 0)
+#endif /** SHELL_COMMAND_SORTED == 1 */
+#if SHELL_COMMAND_INDEX_MAX > 0
+    shellCommandIndexBuild(shell);
+#endif /** SHELL_COMMAND_INDEX_MAX > 0 */
+}
+
+
+/**
+ * @brief shell命令表是否可以按命令名顺序访问
+ * 
+ * @param shell shell对象
+ * @return char 1 命令表已排序或已建立索引 0 只能顺序查找
+ */
+static char shellCommandOrdered(SHELL_TypeDef *shell)
+{
+    if (shell->status.commandSorted)
+    {
+        return 1;
+    }
+#if SHELL_COMMAND_INDEX_MAX > 0
+    if (shellCommandIndex.base == shell->commandBase
+        && shellCommandIndex.number == shell->commandNumber)
     {
-        shellDisplay(shell, shellText[TEXT_CMD_NONE]);
+        return 1;
     }
-    shellDisplay(shell, shell->command);
+#endif /** SHELL_COMMAND_INDEX_MAX > 0 */
+    return 0;
 }
 
 
 /**
- * @brief shell退格输入处理
+ * @brief shell按命令名顺序获取命令
  * 
  * @param shell shell对象
+ * @param order 命令按命令名排序后的位置
+ * @return SHELL_CommandTypeDef* 命令
+ * 
+ * @note 仅在`shellCommandOrdered()`为真时有效
  */
-static void shellBackspace(SHELL_TypeDef *shell)
+static SHELL_CommandTypeDef *shellOrderedCommand(SHELL_TypeDef *shell, unsigned short order)
 {
-    if (shell->length == 0)
+#if SHELL_COMMAND_INDEX_MAX > 0
+    if (!shell->status.commandSorted)
     {
-        return;
+        return shellCommandAt(shell->commandBase, shellCommandIndex.index[order]);
     }
-    if (shell->cursor == shell->length)
+#endif /** SHELL_COMMAND_INDEX_MAX > 0 */
+    return shellCommandAt(shell->commandBase, order);
+}
+
+
+#if SHELL_USING_REGISTRY == 1
+/**
+ * @brief shell运行时注册命令
+ * 
+ * @param command 命令，注册后需要一直有效
+ * @return int 0 注册成功 -1 注册表未解析，注册表已满或命令已存在
+ * 
+ * @note 需要在第一次调用`shellInit()`之后使用，命令按二分查找插入命令索引，不重新排序，
+ *       已排序的命令表因此变为无序时，索引直接按原顺序生成后插入，
+ *       使用共享命令表的shell在下一次处理输入、查找命令或补全时可以使用此命令
+ */
+int shellRegisterCommand(SHELL_CommandTypeDef *command)
+{
+    SHELL_CommandTypeDef *base;
+    unsigned short number;
+
+    SHELL_LIST_LOCK();
+    base = shellRegistry.commandBase;
+    number = shellRegistry.commandNumber + shellRegistry.number;
+    if (!shellRegistry.ready || shellRegistry.number >= SHELL_REGISTRY_COMMAND_NUMBER)
     {
-        shell->length--;
-        shell->cursor--;
-        shell->buffer[shell->length] = 0;
-        shellDelete(shell, 1);
+        SHELL_LIST_UNLOCK();
+        return -1;
     }
-    else if (shell->cursor > 0)
+    for (unsigned short i = 0; i < number; i++)
     {
-        for (short i = 0; i < shell->length - shell->cursor; i++)
+        if (strcmp(shellCommandAt(base, i)->name, command->name) == 0)
         {
-            shell->buffer[shell->cursor + i - 1] = shell->buffer[shell->cursor + i];
+            SHELL_LIST_UNLOCK();
+            return -1;
         }
-        shell->length--;
-        shell->cursor--;
-        shell->buffer[shell->length] = 0;
-        shellDisplayByte(shell, '\b');
-        for (short i = shell->cursor; i < shell->length; i++)
+    }
+    shellRegistry.command[shellRegistry.number++] = command;
+    if (shellRegistry.commandSorted && number > 0
+        && strcmp(shellCommandAt(base, number - 1)->name, command->name) > 0)
+    {
+        shellRegistry.commandSorted = 0;
+    #if SHELL_COMMAND_INDEX_MAX > 0
+        if (number < SHELL_COMMAND_INDEX_MAX)
         {
-            shellDisplayByte(shell, shell->buffer[i]);
+            for (unsigned short i = 0; i < number; i++)
+            {
+                shellCommandIndex.index[i] = i;
+            }
+            shellCommandIndex.base = base;
+            shellCommandIndex.number = number;
         }
-        shellDisplayByte(shell, ' ');
-        for (short i = shell->length - shell->cursor + 1; i > 0; i--)
+    #endif /** SHELL_COMMAND_INDEX_MAX > 0 */
+    }
+#if SHELL_COMMAND_INDEX_MAX > 0
+    if (shellCommandIndex.base == base && shellCommandIndex.number == number
+        && number < SHELL_COMMAND_INDEX_MAX)
+    {
+        unsigned short low = 0;
+        unsigned short high = number;
+        unsigned short mid;
+
+        while (low < high)
         {
-            shellDisplayByte(shell, '\b');
+            mid = low + (high - low) / 2;
+            if (shellCommandIndexCompare(base, shellCommandIndex.index[mid], number) < 0)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
         }
+        memmove(shellCommandIndex.index + low + 1, shellCommandIndex.index + low,
+                (number - low) * sizeof(shellCommandIndex.index[0]));
+        shellCommandIndex.index[low] = number;
+        shellCommandIndex.number = number + 1;
     }
+#endif /** SHELL_COMMAND_INDEX_MAX > 0 */
+    SHELL_LIST_UNLOCK();
+    return 0;
 }
+#endif /** SHELL_USING_REGISTRY == 1 */
 
 
 /**
- * @brief shell Tab键输入处理
+ * @brief shell查找命令名前缀匹配的命令范围
  * 
  * @param shell shell对象
+ * @param prefix 命令名前缀
+ * @param length 前缀长度
+ * @param first 匹配的第一条命令按命令名排序后的位置
+ * @return unsigned short 匹配的命令数量
+ * 
+ * @note 仅在`shellCommandOrdered()`为真时有效，匹配的命令在排序后连续，
+ *       其最长公共前缀即为第一条与最后一条命令的公共前缀
  */
-static void shellTab(SHELL_TypeDef *shell)
+static unsigned short shellCommandRange(SHELL_TypeDef *shell, const char *prefix,
+                                        unsigned short length, unsigned short *first)
 {
-    unsigned short maxMatch = SHELL_COMMAND_MAX_LENGTH;
-    unsigned short lastMatchIndex = 0;
-    unsigned short matchNum = 0;
+    unsigned short low = 0;
+    unsigned short high = shell->commandNumber;
+    unsigned short mid;
+    unsigned short start;
+
+    while (low < high)
+    {
+        mid = low + (high - low) / 2;
+        if (strncmp(shellOrderedCommand(shell, mid)->name, prefix, length) < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    start = low;
+    high = shell->commandNumber;
+    while (low < high)
+    {
+        mid = low + (high - low) / 2;
+        if (strncmp(shellOrderedCommand(shell, mid)->name, prefix, length) == 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    *first = start;
+    return low - start;
+}
+
+
+/**
+ * @brief shell查找命令
+ * 
+ * @param shell shell对象
+ * @param name 命令名
+ * @return SHELL_CommandTypeDef* 查找到的命令，未找到返回NULL
+ */
+static SHELL_CommandTypeDef *shellSeekCommand(SHELL_TypeDef *shell, const char *name)
+{
+    SHELL_CommandTypeDef *base = shell->commandBase;
+    SHELL_CommandTypeDef *command = NULL;
+
+#if SHELL_USING_REGISTRY == 1
+    SHELL_LIST_LOCK();
+    shellRegistrySync(shell);
+#endif /** SHELL_USING_REGISTRY == 1 */
+    if (shellCommandOrdered(shell))
+    {
+        unsigned short low = 0;
+        unsigned short high = shell->commandNumber;
+        unsigned short mid;
+
+        while (low < high)
+        {
+            mid = low + (high - low) / 2;
+            if (strcmp(shellOrderedCommand(shell, mid)->name, name) < 0)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        if (low < shell->commandNumber
+            && strcmp(shellOrderedCommand(shell, low)->name, name) == 0)
+        {
+            command = shellOrderedCommand(shell, low);
+        }
+    }
+    else
+    {
+        for (unsigned short i = 0; i < shell->commandNumber; i++)
+        {
+            if (strcmp(name, shellCommandAt(base, i)->name) == 0)
+            {
+                command = shellCommandAt(base, i);
+                break;
+            }
+        }
+    }
+#if SHELL_USING_REGISTRY == 1
+    SHELL_LIST_UNLOCK();
+#endif /** SHELL_USING_REGISTRY == 1 */
+    return command;
+}
+
+
+/**
+ * @brief shell是否有输出接口
+ * 
+ * @param shell shell对象
+ * @return unsigned char 1 有输出接口 0 没有输出接口
+ */
+static unsigned char shellWritable(SHELL_TypeDef *shell)
+{
+#if SHELL_USING_TELNET == 1
+    if (shell->session)
+    {
+        return 1;
+    }
+#endif /** SHELL_USING_TELNET == 1 */
+    return shell->write != NULL || shell->writeBuffer != NULL;
+}
+
+
+#if SHELL_PRINT_STREAM == 1
+/**
+ * @brief shell流式格式化输出块
+ */
+typedef struct
+{
+    SHELL_TypeDef *shell;                                       /**< shell对象 */
+    unsigned short length;                                      /**< 块数据长度 */
+    char buffer[SHELL_PRINT_CHUNK];                             /**< 块缓冲 */
+} SHELL_PrintStreamDef;
+
+
+/**
+ * @brief shell流式格式化转换说明
+ */
+typedef struct
+{
+    int width;                                                  /**< 宽度 */
+    int precision;                                              /**< 精度，-1为未指定 */
+    char sign;                                                  /**< 非负数的符号，'+'或' '，0为不输出 */
+    unsigned char left : 1;                                     /**< '-'标志，左对齐 */
+    unsigned char zero : 1;                                     /**< '0'标志，补0 */
+    unsigned char alt : 1;                                      /**< '#'标志，输出进制前缀 */
+    unsigned char upper : 1;                                    /**< 是否使用大写十六进制字符 */
+} SHELL_PrintSpecDef;
+
+
+/**
+ * @brief shell流式格式化输出写出块
+ * 
+ * @param stream 输出块
+ */
+static void shellPrintFlush(SHELL_PrintStreamDef *stream)
+{
+    if (stream->length > 0)
+    {
+        shellWriteData(stream->shell, stream->buffer, stream->length);
+        stream->length = 0;
+    }
+}
+
+
+/**
+ * @brief shell流式格式化输出字符
+ * 
+ * @param stream 输出块
+ * @param data 字符
+ * @param count 重复次数
+ */
+static void shellPrintChar(SHELL_PrintStreamDef *stream, char data, int count)
+{
+    while (count-- > 0)
+    {
+        stream->buffer[stream->length++] = data;
+        if (stream->length >= SHELL_PRINT_CHUNK)
+        {
+            shellPrintFlush(stream);
+        }
+    }
+}
+
+
+/**
+ * @brief shell流式格式化输出字符串
+ * 
+ * @param stream 输出块
+ * @param string 字符串
+ * @param length 字符串长度
+ * @param width 宽度
+ * @param left 是否左对齐
+ */
+static void shellPrintString(SHELL_PrintStreamDef *stream, const char *string,
+                             int length, int width, unsigned char left)
+{
+    if (!left)
+    {
+        shellPrintChar(stream, ' ', width - length);
+    }
+    for (int i = 0; i < length; i++)
+    {
+        shellPrintChar(stream, string[i], 1);
+    }
+    if (left)
+    {
+        shellPrintChar(stream, ' ', width - length);
+    }
+}
+
+
+/**
+ * @brief shell流式格式化输出数字
+ * 
+ * @param stream 输出块
+ * @param value 数字绝对值
+ * @param base 进制
+ * @param sign 符号，为0时不输出符号
+ * @param prefix 前缀，如`0x`，为NULL时不输出前缀
+ * @param spec 转换说明
+ * 
+ * @note 宽度包含符号和前缀，补0位于符号、前缀与数字之间，指定精度时忽略`0`标志
+ */
+static void shellPrintNumber(SHELL_PrintStreamDef *stream, unsigned long value,
+                             unsigned char base, char sign, const char *prefix,
+                             const SHELL_PrintSpecDef *spec)
+{
+    char digits[sizeof(unsigned long) * 3 + 1];
+    int length = sizeof(digits);
+    int zeros;
+    int pad;
+    char tmp;
+
+    while (value || (length == (int)sizeof(digits) && spec->precision != 0))
+    {
+        tmp = value % base;
+        digits[--length] = (tmp > 9) ? (tmp + (spec->upper ? 55 : 87)) : (tmp + 48);
+        value /= base;
+    }
+    zeros = spec->precision - ((int)sizeof(digits) - length);
+    zeros = (zeros > 0) ? zeros : 0;
+    if (spec->alt && base == 8 && zeros == 0
+        && (length == (int)sizeof(digits) || digits[length] != '0'))
+    {
+        zeros = 1;
+    }
+    pad = spec->width - ((sign != 0) + (prefix ? (int)strlen(prefix) : 0)
+                         + zeros + ((int)sizeof(digits) - length));
+    if (!spec->left && spec->zero && spec->precision < 0 && pad > 0)
+    {
+        zeros += pad;
+        pad = 0;
+    }
+    if (!spec->left)
+    {
+        shellPrintChar(stream, ' ', pad);
+    }
+    shellPrintChar(stream, sign, sign != 0);
+    if (prefix)
+    {
+        shellPrintString(stream, prefix, strlen(prefix), 0, 0);
+    }
+    shellPrintChar(stream, '0', zeros);
+    shellPrintString(stream, digits + length, sizeof(digits) - length, 0, 0);
+    if (spec->left)
+    {
+        shellPrintChar(stream, ' ', pad);
+    }
+}
+
+
+/**
+ * @brief shell流式格式化
+ * 
+ * @param stream 输出块
+ * @param fmt 格式化字符串
+ * @param vargs 参数
+ * 
+ * @note 支持的转换说明与`vsnprintf`结果一致，`%p`输出`0x`加十六进制地址，空指针输出`0x0`
+ * @note 不支持`ll`、`j`和`L`修饰以及浮点、`%n`等转换，这些转换说明原样输出，
+ *       但仍按`vsnprintf`的规则取出对应的参数，之后的参数不会错位
+ */
+static void shellFormat(SHELL_PrintStreamDef *stream, const char *fmt, va_list vargs)
+{
+    const char *start;
+    SHELL_PrintSpecDef spec;
+    char modifier;
+    unsigned long value;
+    long signedValue;
+    const char *string;
+    int length;
+
+    while (*fmt)
+    {
+        if (*fmt != '%')
+        {
+            shellPrintChar(stream, *fmt++, 1);
+            continue;
+        }
+        start = fmt++;
+        memset(&spec, 0, sizeof(spec));
+        spec.precision = -1;
+        modifier = 0;
+        while (*fmt == '-' || *fmt == '0' || *fmt == '+' || *fmt == ' ' || *fmt == '#')
+        {
+            switch (*fmt++)
+            {
+            case '-':
+                spec.left = 1;
+                break;
+            case '0':
+                spec.zero = 1;
+                break;
+            case '+':
+                spec.sign = '+';
+                break;
+            case ' ':
+                spec.sign = (spec.sign == '+') ? '+' : ' ';
+                break;
+            default:
+                spec.alt = 1;
+                break;
+            }
+        }
+        if (*fmt == '*')
+        {
+            spec.width = va_arg(vargs, int);
+            if (spec.width < 0)
+            {
+                spec.left = 1;
+                spec.width = -spec.width;
+            }
+            fmt++;
+        }
+        while (*fmt >= '0' && *fmt <= '9')
+        {
+            spec.width = spec.width * 10 + *fmt++ - '0';
+        }
+        if (*fmt == '.')
+        {
+            spec.precision = 0;
+            if (*++fmt == '*')
+            {
+                spec.precision = va_arg(vargs, int);
+                spec.precision = (spec.precision < 0) ? -1 : spec.precision;
+                fmt++;
+            }
+            while (*fmt >= '0' && *fmt <= '9')
+            {
+                spec.precision = spec.precision * 10 + *fmt++ - '0';
+            }
+        }
+        if (*fmt == 'h' || *fmt == 'l' || *fmt == 'z' || *fmt == 't' || *fmt == 'j' || *fmt == 'L')
+        {
+            modifier = *fmt++;
+            if ((modifier == 'h' || modifier == 'l') && *fmt == modifier)
+            {
+                modifier = (modifier == 'h') ? 'H' : 'q';
+                fmt++;
+            }
+        }
+        switch ((modifier == 'q' || modifier == 'j' || modifier == 'L') ? 0 : *fmt)
+        {
+        case 'd':
+        case 'i':
+            signedValue = (modifier == 'l' || modifier == 'z' || modifier == 't')
+                          ? va_arg(vargs, long) : va_arg(vargs, int);
+            signedValue = (modifier == 'h') ? (short)signedValue
+                          : (modifier == 'H') ? (signed char)signedValue : signedValue;
+            shellPrintNumber(stream,
+                             (signedValue < 0) ? -(unsigned long)signedValue
+                                               : (unsigned long)signedValue,
+                             10, (signedValue < 0) ? '-' : spec.sign, NULL, &spec);
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            value = (modifier == 'l' || modifier == 'z' || modifier == 't')
+                    ? va_arg(vargs, unsigned long) : va_arg(vargs, unsigned int);
+            value = (modifier == 'h') ? (unsigned short)value
+                    : (modifier == 'H') ? (unsigned char)value : value;
+            spec.upper = (*fmt == 'X');
+            shellPrintNumber(stream, value,
+                             (*fmt == 'u') ? 10 : ((*fmt == 'o') ? 8 : 16), 0,
+                             (spec.alt && value != 0 && *fmt != 'u' && *fmt != 'o')
+                             ? ((*fmt == 'X') ? "0X" : "0x") : NULL,
+                             &spec);
+            break;
+        case 'p':
+            spec.alt = 0;
+            shellPrintNumber(stream, (unsigned long)(size_t)va_arg(vargs, void *),
+                             16, 0, "0x", &spec);
+            break;
+        case 'c':
+            shellPrintChar(stream, ' ', spec.left ? 0 : spec.width - 1);
+            shellPrintChar(stream, (char)va_arg(vargs, int), 1);
+            shellPrintChar(stream, ' ', spec.left ? spec.width - 1 : 0);
+            break;
+        case 's':
+            string = va_arg(vargs, const char *);
+            string = string ? string : "(null)";
+            length = 0;
+            while (string[length] && (spec.precision < 0 || length < spec.precision))
+            {
+                length++;
+            }
+            shellPrintString(stream, string, length, spec.width, spec.left);
+            break;
+        case '%':
+            shellPrintChar(stream, '%', 1);
+            break;
+        default:
+            switch (*fmt)
+            {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                (void)va_arg(vargs, long long);
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (modifier == 'L')
+                {
+                    (void)va_arg(vargs, long double);
+                }
+                else
+                {
+                    (void)va_arg(vargs, double);
+                }
+                break;
+            case 'n':
+                (void)va_arg(vargs, void *);
+                break;
+            default:
+                break;
+            }
+            shellPrintString(stream, start, fmt - start + (*fmt != 0), 0, 0);
+            if (*fmt == 0)
+            {
+                return;
+            }
+            break;
+        }
+        fmt++;
+    }
+}
+
+
+/**
+ * @brief shell格式化输出
+ * 
+ * @param shell shell对象
+ * @param fmt 格式化字符串
+ * @param ... 参数
+ * 
+ * @note 格式化结果按`SHELL_PRINT_CHUNK`大小的块写出，不截断输出
+ */
+void shellPrint(SHELL_TypeDef *shell, char *fmt, ...)
+{
+    SHELL_PrintStreamDef stream;
+    va_list vargs;
+
+    if (!shell || !shellWritable(shell))
+    {
+        return;
+    }
+
+    stream.shell = shell;
+    stream.length = 0;
+    va_start(vargs, fmt);
+    shellFormat(&stream, fmt, vargs);
+    va_end(vargs);
+    shellPrintFlush(&stream);
+}
+#elif SHELL_PRINT_BUFFER > 0
+/**
+ * @brief shell格式化输出
+ * 
+ * @param shell shell对象
+ * @param fmt 格式化字符串
+ * @param ... 参数
+ */
+void shellPrint(SHELL_TypeDef *shell, char *fmt, ...)
+{
+    char buffer[SHELL_PRINT_BUFFER];
+    va_list vargs;
+
+    if (!shell)
+    {
+        return;
+    }
+
+    va_start(vargs, fmt);
+    vsnprintf(buffer, SHELL_PRINT_BUFFER - 1, fmt, vargs);
+    va_end(vargs);
+    
+    shellDisplay(shell, buffer);
+}
+#endif
+
+
+#if SHELL_TX_BUFFER_SIZE > 0
+/**
+ * @brief shell数据存入发送缓冲
+ * 
+ * @param shell shell对象
+ * @param data 数据
+ * @param length 数据长度
+ * 
+ * @note 缓冲满时，根据`SHELL_TX_FULL_POLICY`阻塞，丢弃新数据或者覆盖最旧的数据，
+ *       覆盖时只丢弃正在发送的数据之后最旧的未发送数据，正在发送的数据占满缓冲时丢弃新数据
+ */
+static void shellTxPut(SHELL_TypeDef *shell, const char *data, unsigned short length)
+{
+    unsigned short space;
+    unsigned short count;
+#if SHELL_TX_FULL_POLICY == SHELL_TX_FULL_OVERWRITE
+    unsigned short room;
+    unsigned short keep;
+    unsigned short from;
+    unsigned short to;
+#endif
+
+    while (length)
+    {
+        SHELL_TX_ENTER_CRITICAL();
+        space = SHELL_TX_BUFFER_SIZE - 1
+                - (shell->tx.head + SHELL_TX_BUFFER_SIZE - shell->tx.tail) % SHELL_TX_BUFFER_SIZE;
+    #if SHELL_TX_FULL_POLICY == SHELL_TX_FULL_OVERWRITE
+        if (space < length)
+        {
+            room = SHELL_TX_BUFFER_SIZE - 1 - shell->tx.sending;
+            if (room == 0)
+            {
+                SHELL_TX_EXIT_CRITICAL();
+                return;
+            }
+            count = ((length < room) ? length : room) - space;
+            if (shell->tx.sending == 0)
+            {
+                shell->tx.tail = (shell->tx.tail + count) % SHELL_TX_BUFFER_SIZE;
+            }
+            else
+            {
+                /* 正在发送的数据之后的未发送数据整体前移，丢弃其中最旧的部分 */
+                keep = room - space - count;
+                to = (shell->tx.tail + shell->tx.sending) % SHELL_TX_BUFFER_SIZE;
+                from = (to + count) % SHELL_TX_BUFFER_SIZE;
+                while (keep--)
+                {
+                    shell->tx.buffer[to] = shell->tx.buffer[from];
+                    to = (to + 1) % SHELL_TX_BUFFER_SIZE;
+                    from = (from + 1) % SHELL_TX_BUFFER_SIZE;
+                }
+                shell->tx.head = to;
+            }
+            space += count;
+        }
+    #endif
+        count = (length < space) ? length : space;
+        for (unsigned short i = 0; i < count; i++)
+        {
+            shell->tx.buffer[shell->tx.head] = *data++;
+            shell->tx.head = (shell->tx.head + 1) % SHELL_TX_BUFFER_SIZE;
+        }
+        SHELL_TX_EXIT_CRITICAL();
+        length -= count;
+        if (length == 0)
+        {
+            break;
+        }
+    #if SHELL_TX_FULL_POLICY == SHELL_TX_FULL_BLOCK
+        shellTxDrain(shell);
+    #elif SHELL_TX_FULL_POLICY != SHELL_TX_FULL_OVERWRITE
+        return;
+    #endif
+    }
+}
+
+
+/**
+ * @brief shell发送缓冲数据
+ * 
+ * @param shell shell对象
+ * 
+ * @note 定义了`shell->writeBuffer`时，将一段连续的缓冲数据交给`shell->writeBuffer`发送后
+ *       立即返回，`shell->writeBuffer`不能阻塞，发送完成后需调用`shellTxComplete()`，
+ *       否则通过`shell->write`同步发送缓冲中的所有数据，可在低优先级任务中调用
+ */
+void shellTxDrain(SHELL_TypeDef *shell)
+{
+    const char *data;
+    unsigned short length;
+    char byte;
+
+    if (shell->writeBuffer)
+    {
+        SHELL_TX_ENTER_CRITICAL();
+        if (shell->tx.sending != 0 || shell->tx.head == shell->tx.tail)
+        {
+            SHELL_TX_EXIT_CRITICAL();
+            return;
+        }
+        data = shell->tx.buffer + shell->tx.tail;
+        length = (shell->tx.head > shell->tx.tail)
+                 ? shell->tx.head - shell->tx.tail
+                 : SHELL_TX_BUFFER_SIZE - shell->tx.tail;
+        shell->tx.sending = length;
+        SHELL_TX_EXIT_CRITICAL();
+        shell->writeBuffer(data, length);
+    }
+    else if (shell->write)
+    {
+        while (1)
+        {
+            SHELL_TX_ENTER_CRITICAL();
+            if (shell->tx.head == shell->tx.tail)
+            {
+                SHELL_TX_EXIT_CRITICAL();
+                break;
+            }
+            byte = shell->tx.buffer[shell->tx.tail];
+            shell->tx.tail = (shell->tx.tail + 1) % SHELL_TX_BUFFER_SIZE;
+            SHELL_TX_EXIT_CRITICAL();
+            shell->write(byte);
+        }
+    }
+}
+
+
+/**
+ * @brief shell发送完成
+ * 
+ * @param shell shell对象
+ * 
+ * @note 在`shell->writeBuffer`启动的发送(DMA)完成中断中调用，释放已发送的数据并继续发送
+ */
+void shellTxComplete(SHELL_TypeDef *shell)
+{
+    SHELL_TX_ENTER_CRITICAL();
+    shell->tx.tail = (shell->tx.tail + shell->tx.sending) % SHELL_TX_BUFFER_SIZE;
+    shell->tx.sending = 0;
+    SHELL_TX_EXIT_CRITICAL();
+    shellTxDrain(shell);
+}
+#endif /** SHELL_TX_BUFFER_SIZE > 0 */
+
+
+/**
+ * @brief shell写数据到输出接口
+ * 
+ * @param shell shell对象
+ * @param data 数据
+ * @param length 数据长度
+ * 
+ * @note 定义了`shell->writeBuffer`时，数据整块写出，否则逐字节调用`shell->write`
+ * @note 使用发送缓冲时，数据先存入发送缓冲
+ */
+static void shellWriteRaw(SHELL_TypeDef *shell, const char *data, unsigned short length)
+{
+    if (length == 0 || !shellWritable(shell))
+    {
+        return;
+    }
+#if SHELL_USING_TELNET == 1
+    if (shell->session)
+    {
+        shellTelnetWrite(shell->session, data, length);
+        return;
+    }
+#endif /** SHELL_USING_TELNET == 1 */
+#if SHELL_TX_BUFFER_SIZE > 0
+    shellTxPut(shell, data, length);
+    if (shell->writeBuffer)
+    {
+        shellTxDrain(shell);
+    }
+#else
+    if (shell->writeBuffer)
+    {
+        shell->writeBuffer(data, length);
+    }
+    else
+    {
+        while (length--)
+        {
+            shell->write(*data++);
+        }
+    }
+#endif /** SHELL_TX_BUFFER_SIZE > 0 */
+}
+
+
+#if SHELL_USING_MACHINE == 1
+/**
+ * @brief shell机器模式发送帧
+ * 
+ * @param shell shell对象
+ * @param type 帧类型
+ * @param data 帧数据
+ * @param length 帧数据长度
+ */
+static void shellMachineFrame(SHELL_TypeDef *shell, unsigned char type,
+                              const char *data, unsigned char length)
+{
+    char header[4];
+    char check;
+
+    header[0] = (char)SHELL_MACHINE_SOF;
+    header[1] = type;
+    header[2] = shell->machine.seq;
+    header[3] = length;
+    check = header[1] ^ header[2] ^ header[3];
+    for (unsigned char i = 0; i < length; i++)
+    {
+        check ^= data[i];
+    }
+    shellWriteRaw(shell, header, 4);
+    shellWriteRaw(shell, data, length);
+    shellWriteRaw(shell, &check, 1);
+}
+
+
+/**
+ * @brief shell机器模式发送结果帧
+ * 
+ * @param shell shell对象
+ * @param status 执行状态
+ * @param returnValue 命令返回值
+ */
+static void shellMachineResult(SHELL_TypeDef *shell, unsigned char status, int returnValue)
+{
+    char result[5];
+
+    result[0] = status;
+    for (unsigned char i = 0; i < 4; i++)
+    {
+        result[i + 1] = (char)((unsigned int)returnValue >> (i * 8));
+    }
+    shellMachineFrame(shell, SHELL_MACHINE_RESULT, result, 5);
+}
+#endif /** SHELL_USING_MACHINE == 1 */
+
+
+/**
+ * @brief shell输出数据
+ * 
+ * @param shell shell对象
+ * @param data 数据
+ * @param length 数据长度
+ * 
+ * @note 重定向时，数据写入输出目标，机器模式下，数据以输出帧的形式发送
+ */
+static void shellWriteStream(SHELL_TypeDef *shell, const char *data, unsigned short length)
+{
+#if SHELL_USING_REDIRECT == 1
+    if (shell->sink)
+    {
+        shell->sink->write(shell->sink, data, length);
+        return;
+    }
+#endif /** SHELL_USING_REDIRECT == 1 */
+#if SHELL_USING_MACHINE == 1
+    if (shell->status.machineMode)
+    {
+        while (length)
+        {
+            unsigned char count = (length > 255) ? 255 : length;
+            shellMachineFrame(shell, SHELL_MACHINE_OUTPUT, data, count);
+            data += count;
+            length -= count;
+        }
+        return;
+    }
+#endif /** SHELL_USING_MACHINE == 1 */
+    shellWriteRaw(shell, data, length);
+}
+
+
+#if SHELL_USING_PIPE == 1
+/**
+ * @brief shell管道过滤一行输出
+ * 
+ * @param shell shell对象
+ * 
+ * @note 行依次经过各级过滤，全部通过后输出，`head`只统计到达该级的行
+ */
+static void shellPipeLine(SHELL_TypeDef *shell)
+{
+    shell->pipe.line[shell->pipe.length] = 0;
+    for (unsigned char i = 0; i < shell->pipe.number; i++)
+    {
+        if (shell->pipe.stage[i].type == SHELL_PIPE_GREP)
+        {
+            if (!strstr(shell->pipe.line, shell->pipe.stage[i].pattern))
+            {
+                break;
+            }
+        }
+        else if (shell->pipe.stage[i].count++ >= shell->pipe.stage[i].max)
+        {
+            break;
+        }
+        if (i == shell->pipe.number - 1)
+        {
+            shellWriteStream(shell, shell->pipe.line, shell->pipe.length);
+        }
+    }
+    shell->pipe.length = 0;
+}
+
+
+/**
+ * @brief shell管道写数据
+ * 
+ * @param shell shell对象
+ * @param data 数据
+ * @param length 数据长度
+ * 
+ * @note 数据按行缓存后过滤，超过行缓冲长度的行会被分割为多行处理
+ */
+static void shellPipeWrite(SHELL_TypeDef *shell, const char *data, unsigned short length)
+{
+    while (length--)
+    {
+        shell->pipe.line[shell->pipe.length++] = *data;
+        if (*data++ == '\n' || shell->pipe.length >= SHELL_PIPE_LINE_LENGTH - 1)
+        {
+            shellPipeLine(shell);
+        }
+    }
+}
+#endif /** SHELL_USING_PIPE == 1 */
+
+
+/**
+ * @brief shell写数据
+ * 
+ * @param shell shell对象
+ * @param data 数据
+ * @param length 数据长度
+ * 
+ * @note 使用管道时，数据先经过管道过滤
+ */
+static void shellWriteData(SHELL_TypeDef *shell, const char *data, unsigned short length)
+{
+#if SHELL_USING_PIPE == 1
+    if (shell->pipe.number > 0)
+    {
+        shellPipeWrite(shell, data, length);
+        return;
+    }
+#endif /** SHELL_USING_PIPE == 1 */
+    shellWriteStream(shell, data, length);
+}
+
+
+/**
+ * @brief shell显示字符串
+ * 
+ * @param shell shell对象
+ * @param string 字符串
+ * @return unsigned short 字符串长度
+ */
+unsigned short shellDisplay(SHELL_TypeDef *shell, const char *string)
+{
+    unsigned short count = 0;
+    if (!shellWritable(shell))
+    {
+        return 0;
+    }
+    while (*(string + count))
+    {
+        count++;
+    }
+    shellWriteData(shell, string, count);
+    return count;
+}
+
+
+/**
+ * @brief shell显示字符
+ * 
+ * @param shell shel对象
+ * @param data 字符
+ */
+static void shellDisplayByte(SHELL_TypeDef *shell, char data)
+{
+    shellWriteData(shell, &data, 1);
+}
+
+
+/**
+ * @brief shell重复显示字符
+ * 
+ * @param shell shell对象
+ * @param data 字符
+ * @param count 重复次数
+ */
+static void shellDisplayRepeat(SHELL_TypeDef *shell, char data, unsigned short count)
+{
+    char buffer[16];
+    unsigned short length;
+
+    memset(buffer, data, (count > sizeof(buffer)) ? sizeof(buffer) : count);
+    while (count)
+    {
+        length = (count > sizeof(buffer)) ? sizeof(buffer) : count;
+        shellWriteData(shell, buffer, length);
+        count -= length;
+    }
+}
+
+
+#if SHELL_USING_VAR == 1 || SHELL_DISPLAY_RETURN == 1
+/**
+ * @brief 两位十进制数字查找表
+ */
+static const char shellDecimalPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+
+/**
+ * @brief shell格式化值
+ * 
+ * @param buffer 缓冲，至少需要25字节
+ * @param value 值
+ * @param format 格式，`SHELL_RETURN_DEC`和`SHELL_RETURN_HEX`的组合
+ * @return unsigned short 格式化后的长度，包括结尾的"\r\n"
+ * 
+ * @note 十进制每次转换两位，十六进制为固定8位
+ */
+static unsigned short shellFormatValue(char *buffer, int value, unsigned char format)
+{
+    char str[10];
+    unsigned int v = (value < 0) ? -(unsigned int)value : (unsigned int)value;
+    unsigned short length = 0;
+    signed char i = 10;
+
+    if (format & SHELL_RETURN_DEC)
+    {
+        while (v >= 100)
+        {
+            i -= 2;
+            str[i] = shellDecimalPairs[(v % 100) * 2];
+            str[i + 1] = shellDecimalPairs[(v % 100) * 2 + 1];
+            v /= 100;
+        }
+        if (v >= 10)
+        {
+            i -= 2;
+            str[i] = shellDecimalPairs[v * 2];
+            str[i + 1] = shellDecimalPairs[v * 2 + 1];
+        }
+        else
+        {
+            str[--i] = v + '0';
+        }
+        if (value < 0)
+        {
+            buffer[length++] = '-';
+        }
+        memcpy(buffer + length, str + i, 10 - i);
+        length += 10 - i;
+    }
+    if (format & SHELL_RETURN_HEX)
+    {
+        if (format & SHELL_RETURN_DEC)
+        {
+            buffer[length++] = ',';
+            buffer[length++] = ' ';
+        }
+        buffer[length++] = '0';
+        buffer[length++] = 'x';
+        v = (unsigned int)value;
+        for (i = 7; i >= 0; i--)
+        {
+            buffer[length + i] = "0123456789abcdef"[v & 0x0000000F];
+            v >>= 4;
+        }
+        length += 8;
+    }
+    buffer[length++] = '\r';
+    buffer[length++] = '\n';
+    return length;
+}
+
+
+#endif /** SHELL_USING_VAR == 1 || SHELL_DISPLAY_RETURN == 1 */
+
+
+#if SHELL_USING_VAR == 1
+/**
+ * @brief shell显示值
+ * 
+ * @param shell shell对象
+ * @param value 值
+ * 
+ * @note 以十进制和十六进制显示，整行一次写出
+ */
+static void shellDisplayValue(SHELL_TypeDef *shell, int value)
+{
+    char buffer[25];
+
+    shellWriteData(shell, buffer,
+                   shellFormatValue(buffer, value, SHELL_RETURN_DEC | SHELL_RETURN_HEX));
+}
+#endif /** SHELL_USING_VAR == 1 */
+
+
+#if SHELL_DISPLAY_RETURN == 1
+/**
+ * @brief shell显示函数调用返回值
+ * 
+ * @param shell shel对象
+ * @param value 值
+ * 
+ * @note 返回值格式由`SHELL_RETURN_FORMAT`决定，整行一次写出
+ */
+static void shellDisplayReturn(SHELL_TypeDef *shell, int value)
+{
+    char buffer[33] = "Return: ";
+
+    shellWriteData(shell, buffer,
+                   8 + shellFormatValue(buffer + 8, value, SHELL_RETURN_FORMAT));
+}
+#endif /** SHELL_DISPLAY_RETURN == 1 */
+
+
+/**
+ * @brief shell字符串复制
+ * 
+ * @param dest 目标字符串
+ * @param src 源字符串
+ * @return unsigned short 字符串长度
+ */
+static unsigned short shellStringCopy(char *dest, char* src)
+{
+    unsigned short count = 0;
+    while (*(src + count))
+    {
+        *(dest + count) = *(src + count);
+        count++;
+    }
+    *(dest + count) = 0;
+    return count;
+}
+
+
+/**
+ * @brief shell字符串比较
+ * 
+ * @param dest 目标字符串
+ * @param src 源字符串
+ * @return unsigned short 匹配长度
+ */
+static unsigned short shellStringCompare(char* dest, char *src)
+{
+    unsigned short match = 0;
+    unsigned short i = 0;
+
+    while (*(dest +i) && *(src + i))
+    {
+        if (*(dest + i) != *(src +i))
+        {
+            break;
+        }
+        match ++;
+        i++;
+    }
+    return match;
+}
+
+
+#if SHELL_ANSI_EDIT == 1
+/**
+ * @brief shell生成CSI控制序列
+ * 
+ * @param buffer 输出缓冲
+ * @param param 控制序列参数，小于等于1时省略
+ * @param finalCode 控制序列结束字符
+ * @return unsigned short 控制序列长度
+ */
+static unsigned short shellCsiFormat(char *buffer, unsigned short param, char finalCode)
+{
+    char digits[5];
+    unsigned short count = 0;
+    unsigned short length = 2;
+
+    buffer[0] = SHELL_KEY_ESC;
+    buffer[1] = '[';
+    if (param > 1)
+    {
+        while (param)
+        {
+            digits[count++] = param % 10 + '0';
+            param /= 10;
+        }
+        while (count)
+        {
+            buffer[length++] = digits[--count];
+        }
+    }
+    buffer[length++] = finalCode;
+    return length;
+}
+
+
+/**
+ * @brief shell生成光标左移序列
+ * 
+ * @param buffer 输出缓冲
+ * @param count 左移的字符数
+ * @return unsigned short 序列长度
+ * 
+ * @note 移动距离较短时直接使用`\b`
+ */
+static unsigned short shellCursorBackFormat(char *buffer, unsigned short count)
+{
+    if (count > 3)
+    {
+        return shellCsiFormat(buffer, count, 'D');
+    }
+    for (unsigned short i = 0; i < count; i++)
+    {
+        buffer[i] = '\b';
+    }
+    return count;
+}
+#endif /** SHELL_ANSI_EDIT == 1 */
+
+
+/**
+ * @brief shell删除
+ * 
+ * @param shell shell对象
+ * @param length 删除的长度
+ */
+static void shellDelete(SHELL_TypeDef *shell, unsigned short length)
+{
+#if SHELL_ANSI_EDIT == 1
+    char buffer[16];
+    unsigned short count;
+
+    count = shellCursorBackFormat(buffer, length);
+    count += shellCsiFormat(buffer + count, 0, 'K');
+    shellWriteData(shell, buffer, count);
+#else
+    shellDisplayRepeat(shell, '\b', length);
+    shellDisplayRepeat(shell, ' ', length);
+    shellDisplayRepeat(shell, '\b', length);
+#endif /** SHELL_ANSI_EDIT == 1 */
+}
+
+
+/**
+ * @brief shell清除输入
+ * 
+ * @param shell shell对象
+ */
+static void shellClearLine(SHELL_TypeDef *shell)
+{
+#if SHELL_ANSI_EDIT == 1
+    shellDelete(shell, shell->cursor);
+#else
+    shellDisplayRepeat(shell, ' ', shell->length - shell->cursor);
+    shellDelete(shell, shell->length);
+#endif /** SHELL_ANSI_EDIT == 1 */
+}
+
+
+/**
+ * @brief shell获取历史记录
+ * 
+ * @param shell shell对象
+ * @param index 记录序号，0为最新的记录
+ * @return char* 历史记录，序号超出记录数量时返回NULL
+ */
+static char *shellHistoryGet(SHELL_TypeDef *shell, unsigned short index)
+{
+#if SHELL_HISTORY_BUFFER_SIZE > 0
+    char *record = shell->history;
+#endif /** SHELL_HISTORY_BUFFER_SIZE > 0 */
+
+    if (index >= shell->historyCount)
+    {
+        return NULL;
+    }
+#if SHELL_HISTORY_BUFFER_SIZE > 0
+    while (index--)
+    {
+        record += strlen(record) + 1;
+    }
+    return record;
+#else
+    return shell->history[(shell->historyFlag + SHELL_HISTORY_MAX_NUMBER - 1 - index)
+                          % SHELL_HISTORY_MAX_NUMBER];
+#endif /** SHELL_HISTORY_BUFFER_SIZE > 0 */
+}
+
+
+/**
+ * @brief shell历史记录添加
+ * 
+ * @param shell shell对象
+ */
+static void shellHistoryAdd(SHELL_TypeDef *shell)
+{
+#if SHELL_HISTORY_BUFFER_SIZE > 0
+    unsigned short length = shell->length + 1;
+    unsigned short used = 0;
+
+    shell->historyOffset = 0;
+#if SHELL_HISTORY_ATTACH == 1
+    if (!shell->history)
+    {
+        return;
+    }
+#endif /** SHELL_HISTORY_ATTACH == 1 */
+    if ((shell->historyCount > 0 && strcmp(shell->history, shell->buffer) == 0)
+        || length > SHELL_HISTORY_BUFFER_SIZE)
+    {
+        return;
+    }
+    memmove(shell->history + length, shell->history,
+            (shell->historyLength + length > SHELL_HISTORY_BUFFER_SIZE)
+            ? SHELL_HISTORY_BUFFER_SIZE - length : shell->historyLength);
+    memcpy(shell->history, shell->buffer, length);
+    shell->historyLength += length;
+    if (shell->historyLength > SHELL_HISTORY_BUFFER_SIZE)
+    {
+        shell->historyLength = SHELL_HISTORY_BUFFER_SIZE;
+    }
+
+    shell->historyCount = 0;
+    for (unsigned short i = 0; i < shell->historyLength; i++)
+    {
+        if (shell->history[i] == 0)
+        {
+            used = i + 1;
+            shell->historyCount++;
+        }
+    }
+    shell->historyLength = used;
+#else
+    shell->historyOffset = 0;
+    if (strcmp(shell->history[shell->historyFlag - 1], shell->buffer) == 0)
+    {
+        return;
+    }
+    if (shellStringCopy(shell->history[shell->historyFlag], shell->buffer) != 0)
+    {
+        shell->historyFlag++;
+    }
+    if (++shell->historyCount > SHELL_HISTORY_MAX_NUMBER)
+    {
+        shell->historyCount = SHELL_HISTORY_MAX_NUMBER;
+    }
+    if (shell->historyFlag >= SHELL_HISTORY_MAX_NUMBER)
+    {
+        shell->historyFlag = 0;
+    }
+#endif /** SHELL_HISTORY_BUFFER_SIZE > 0 */
+}
+
+
+/**
+ * @brief shell历史记录查找
+ * 
+ * @param shell shell对象
+ * @param dir 查找方向
+ */
+static void shellHistory(SHELL_TypeDef *shell, unsigned char dir)
+{
+#if SHELL_USING_AUTH == 1
+    if (!shell->status.authFlag)
+    {
+        return;
+    }
+#endif
+    if (dir == 0)
+    {
+        if (shell->historyOffset-- <= -shell->historyCount)
+        {
+            shell->historyOffset = -shell->historyCount;
+        }
+    }
+    else if (dir == 1)
+    {
+        if (++shell->historyOffset > 0)
+        {
+            shell->historyOffset = 0;
+            return;
+        }
+    }
+    else
+    {
+        return;
+    }
+    shellClearLine(shell);
+    if (shell->historyOffset == 0)
+    {
+        shell->cursor = shell->length = 0;
+    }
+    else
+    {
+        if ((shell->length = shellStringCopy(shell->buffer,
+                shellHistoryGet(shell, -shell->historyOffset - 1))) == 0)
+        {
+            return;
+        }
+        shell->cursor = shell->length;
+        shellDisplay(shell, shell->buffer);
+    }
+}
+
+
+#if SHELL_HISTORY_SEARCH == 1
+/**
+ * @brief shell历史记录搜索匹配
+ * 
+ * @param shell shell对象
+ * @param index 开始匹配的记录序号
+ * 
+ * @note 关键字保存在命令缓冲中，从`index`开始向旧的记录匹配，找到时更新匹配序号，
+ *       找不到时保留之前的匹配，只标记搜索失败，
+ *       关键字增加字符时，比当前匹配更新的记录不可能匹配，因此只需从当前匹配开始查找
+ * @note 使用历史记录缓冲时，记录依次存放，逐条后移记录指针，不重复从头查找
+ */
+static void shellSearchFind(SHELL_TypeDef *shell, unsigned short index)
+{
+    char *record;
+
+    shell->search.failed = 0;
+    if (shell->length == 0)
+    {
+        shell->search.found = 0;
+        return;
+    }
+    record = shellHistoryGet(shell, index);
+    while (record != NULL)
+    {
+        if (strstr(record, shell->buffer))
+        {
+            shell->search.index = index;
+            shell->search.found = 1;
+            return;
+        }
+        if (++index >= shell->historyCount)
+        {
+            break;
+        }
+    #if SHELL_HISTORY_BUFFER_SIZE > 0
+        record += strlen(record) + 1;
+    #else
+        record = shellHistoryGet(shell, index);
+    #endif /** SHELL_HISTORY_BUFFER_SIZE > 0 */
+    }
+    shell->search.failed = 1;
+}
+
+
+/**
+ * @brief shell历史记录搜索显示
+ * 
+ * @param shell shell对象
+ * 
+ * @note 只删除并重新输出提示符之后的搜索行
+ */
+static void shellSearchDisplay(SHELL_TypeDef *shell)
+{
+    shellDelete(shell, shell->search.display);
+    shell->search.display = shellDisplay(shell,
+        shell->search.failed ? "(failed reverse-i-search)`" : "(reverse-i-search)`");
+    shell->search.display += shellDisplay(shell, shell->buffer);
+    shell->search.display += shellDisplay(shell, "': ");
+    if (shell->search.found)
+    {
+        shell->search.display += shellDisplay(shell, shellHistoryGet(shell, shell->search.index));
+    }
+}
+
+
+/**
+ * @brief shell开始历史记录搜索
+ * 
+ * @param shell shell对象
+ */
+static void shellSearchStart(SHELL_TypeDef *shell)
+{
+#if SHELL_USING_AUTH == 1
+    if (!shell->status.authFlag)
+    {
+        return;
+    }
+#endif
+    shellClearLine(shell);
+    shell->length = 0;
+    shell->cursor = 0;
+    shell->buffer[0] = 0;
+    shell->historyOffset = 0;
+    shell->search.index = 0;
+    shell->search.found = 0;
+    shell->search.failed = 0;
+    shell->search.display = 0;
+    shell->status.searchMode = 1;
+    shellSearchDisplay(shell);
+}
+
+
+/**
+ * @brief shell结束历史记录搜索
+ * 
+ * @param shell shell对象
+ * @param accept 是否将匹配的记录放入命令行
+ */
+static void shellSearchEnd(SHELL_TypeDef *shell, unsigned char accept)
+{
+    shellDelete(shell, shell->search.display);
+    shell->status.searchMode = 0;
+    shell->length = 0;
+    if (accept && shell->search.found)
+    {
+        shell->length = shellStringCopy(shell->buffer,
+                                        shellHistoryGet(shell, shell->search.index));
+    }
+    shell->buffer[shell->length] = 0;
+    shell->cursor = shell->length;
+    shellDisplay(shell, shell->buffer);
+}
+
+
+/**
+ * @brief shell历史记录搜索输入处理
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ * @return unsigned char 0 输入已处理
+ *                       1 搜索已结束，输入需要按正常方式继续处理
+ */
+static unsigned char shellSearchInput(SHELL_TypeDef *shell, char data)
+{
+    switch (data)
+    {
+    case SHELL_KEY_CTRL_R:
+        if (shell->search.found)
+        {
+            shellSearchFind(shell, shell->search.index + 1);
+        }
+        break;
+    case SHELL_KEY_BACKSPACE:
+    case SHELL_KEY_DELETE:
+        if (shell->length > 0)
+        {
+            shell->buffer[--shell->length] = 0;
+            shell->cursor = shell->length;
+        }
+        /* 关键字变短后，比当前匹配更新的记录可能重新匹配，从最新的记录开始查找 */
+        shellSearchFind(shell, 0);
+        break;
+    case SHELL_KEY_CTRL_C:
+    case SHELL_KEY_CTRL_G:
+        shellSearchEnd(shell, 0);
+        return 0;
+    default:
+        if ((unsigned char)data < 0x20)
+        {
+            shellSearchEnd(shell, 1);
+            return 1;
+        }
+        if (shell->length < SHELL_COMMAND_MAX_LENGTH - 1)
+        {
+            shell->buffer[shell->length++] = data;
+            shell->buffer[shell->length] = 0;
+            shell->cursor = shell->length;
+            if (shell->search.found)
+            {
+                shellSearchFind(shell, shell->search.index);
+            }
+            else if (shell->length == 1)
+            {
+                shellSearchFind(shell, 0);
+            }
+        }
+        break;
+    }
+    shellSearchDisplay(shell);
+    return 0;
+}
+#endif /** SHELL_HISTORY_SEARCH == 1 */
+
+
+#if SHELL_AUTO_PRASE == 1
+/**
+ * @brief 解析转义字符
+ * 
+ * @param data 转义符`\`后的字符
+ * @return char 转义后的字符
+ */
+static char shellEscapeChar(char data)
+{
+    switch (data)
+    {
+    case 'b':
+        return '\b';
+    case 'r':
+        return '\r';
+    case 'n':
+        return '\n';
+    case 't':
+        return '\t';
+    case '0':
+        return 0;
+    default:
+        return data;
+    }
+}
+#endif /** SHELL_AUTO_PRASE == 1 */
+
+
+/**
+ * @brief shell参数解析
+ * 
+ * @param shell shell对象
+ * @return unsigned char 参数个数
+ * 
+ * @note 单次遍历输入缓冲，原地完成参数切分、去除引号、转义字符处理和参数分类，
+ *       参数类型和长度记录在paramType和paramLength中，执行命令时不再重复扫描参数
+ * @note 未使能SHELL_AUTO_PRASE时，保留转义字符原文，仅去除引号
+ * @note 参数数量未达到上限时，最后一个参数之后的位置置为NULL，与argv一致
+ */
+static unsigned char shellParseParam(SHELL_TypeDef *shell)
+{
+    char *buffer = shell->buffer;
+    unsigned short read = 0;
+    unsigned short write = 0;
+    unsigned short start;
+    unsigned char paramCount = 0;
+    unsigned char quotes;
+    unsigned char type;
+
+    while (paramCount < SHELL_PARAMETER_MAX_NUMBER)
+    {
+        while (buffer[read] == ' ' || buffer[read] == '\t' || buffer[read] == ',')
+        {
+            read++;
+        }
+        if (buffer[read] == 0)
+        {
+            break;
+        }
+
+        type = SHELL_PARAM_STRING;
+        if (buffer[read] == '\'' && buffer[read + 1])
+        {
+            type = SHELL_PARAM_CHAR;
+        }
+        else if (buffer[read] == '-' || (buffer[read] >= '0' && buffer[read] <= '9'))
+        {
+            type = SHELL_PARAM_NUMBER;
+        }
+    #if SHELL_USING_VAR == 1
+        else if (buffer[read] == '$' && buffer[read + 1])
+        {
+            type = SHELL_PARAM_VAR;
+        }
+    #endif /** SHELL_USING_VAR == 1 */
+
+        start = write;
+        quotes = 0;
+        while (buffer[read] != 0
+            && (quotes || (buffer[read] != ' ' && buffer[read] != '\t' && buffer[read] != ',')))
+        {
+            if (buffer[read] == '\"')
+            {
+                quotes = !quotes;
+                read++;
+                continue;
+            }
+            if (buffer[read] == '\\' && buffer[read + 1])
+            {
+            #if SHELL_AUTO_PRASE == 1
+                buffer[write++] = shellEscapeChar(buffer[read + 1]);
+                read += 2;
+                continue;
+            #else
+                buffer[write++] = buffer[read++];
+            #endif /** SHELL_AUTO_PRASE == 1 */
+            }
+            buffer[write++] = buffer[read++];
+        }
+
+    #if SHELL_AUTO_PRASE == 1
+        if (type == SHELL_PARAM_CHAR)
+        {
+            buffer[start] = (write - start > 1) ? buffer[start + 1] : 0;
+            write = start + 1;
+        }
+    #endif /** SHELL_AUTO_PRASE == 1 */
+
+        shell->param[paramCount] = buffer + start;
+        shell->paramType[paramCount] = type;
+        shell->paramLength[paramCount] = write - start;
+        paramCount++;
+        if (buffer[read] != 0)
+        {
+            read++;
+        }
+        buffer[write++] = 0;
+    }
+    if (paramCount < SHELL_PARAMETER_MAX_NUMBER)
+    {
+        shell->param[paramCount] = NULL;
+    }
+    return paramCount;
+}
+
+
+#if SHELL_USING_STATS == 1
+/**
+ * @brief shell记录命令执行统计
+ * 
+ * @param command 执行的命令
+ * @param time 执行时间，单位为`SHELL_STATS_TICK()`单位
+ * 
+ * @note 统计按命令条目记录，不同命令表以及运行时注册的命令互不影响
+ */
+static void shellStatsRecord(SHELL_CommandTypeDef *command, unsigned int time)
+{
+    SHELL_CommandStatDef *stat = NULL;
+
+    for (unsigned short i = 0; i < SHELL_STATS_NUMBER; i++)
+    {
+        if (shellCommandStats[i].command == command)
+        {
+            stat = &shellCommandStats[i];
+            break;
+        }
+        if (!shellCommandStats[i].command)
+        {
+            stat = &shellCommandStats[i];
+            stat->command = command;
+            break;
+        }
+    }
+    if (!stat)
+    {
+        return;
+    }
+    if (stat->count == 0 || time < stat->min)
+    {
+        stat->min = time;
+    }
+    if (time > stat->max)
+    {
+        stat->max = time;
+    }
+    stat->total += time;
+    stat->count++;
+}
+#endif /** SHELL_USING_STATS == 1 */
+
+
+/**
+ * @brief shell调用已解析的命令
+ * 
+ * @param shell shell对象
+ * @param paramCount 参数个数
+ * @param returnValue 命令返回值
+ * @return signed char 0 执行了命令函数 1 shell内部处理(help, 变量显示) -1 命令不存在
+ */
+static signed char shellDispatch(SHELL_TypeDef *shell, unsigned char paramCount, int *returnValue)
+{
+    SHELL_CommandTypeDef *command;
+    SHELL_TypeDef *last;
+#if SHELL_USING_STATS == 1
+    unsigned int start;
+#endif /** SHELL_USING_STATS == 1 */
+
+    if (strcmp((const char *)shell->param[0], "help") == 0)
+    {
+        shellShowHelp(shell, paramCount, shell->param);
+        return 1;
+    }
+#if SHELL_USING_VAR == 1
+    if (shell->param[0][0] == '$')
+    {
+        shellDisplayVariable(shell, shell->param[0]);
+        return 1;
+    }
+#endif /** SHELL_USING_VAR == 1 */
+    command = shellSeekCommand(shell, (const char *)shell->param[0]);
+    if (!command)
+    {
+        shellDisplay(shell, shellText[TEXT_CMD_NONE]);
+        return -1;
+    }
+    last = shellSetCurrent(shell);
+#if SHELL_USING_STATS == 1
+    start = SHELL_STATS_TICK();
+#endif /** SHELL_USING_STATS == 1 */
+#if SHELL_AUTO_PRASE == 0
+    *returnValue = command->function(paramCount, shell->param);
+#else
+#if SHELL_TYPED_COMMAND == 1
+    if (command->signature)
+    {
+        *returnValue = shellExtRunTyped(shell, command->signature,
+                                        command->function, paramCount, shell->param);
+    }
+    else
+#endif /** SHELL_TYPED_COMMAND == 1 */
+    {
+        *returnValue = shellExtRun(shell, command->function, paramCount, shell->param);
+    }
+#endif /** SHELL_AUTO_PRASE == 0 */
+#if SHELL_USING_STATS == 1
+    shellStatsRecord(command, SHELL_STATS_TICK() - start);
+#endif /** SHELL_USING_STATS == 1 */
+    shellSetCurrent(last);
+    return 0;
+}
+
+
+#if SHELL_USING_PIPE == 1
+/**
+ * @brief shell解析管道
+ * 
+ * @param shell shell对象
+ * @param paramCount 参数个数，解析后为管道前的参数个数
+ * @return signed char 0 解析成功 -1 管道格式错误
+ * 
+ * @note 单独的`|`参数分隔管道各级，每级为`grep [pattern]`或`head [n]`
+ */
+static signed char shellPipeParse(SHELL_TypeDef *shell, unsigned char *paramCount)
+{
+    unsigned char count = *paramCount;
+    unsigned char index = 1;
+    char *name;
+    char *arg;
+
+    while (index < count && strcmp(shell->param[index], "|") != 0)
+    {
+        index++;
+    }
+    *paramCount = index;
+    shell->pipe.length = 0;
+    shell->pipe.number = 0;
+    while (index < count)
+    {
+        if (index + 2 >= count || shell->pipe.number >= SHELL_PIPE_STAGE_NUMBER)
+        {
+            return -1;
+        }
+        name = shell->param[index + 1];
+        arg = shell->param[index + 2];
+        if (strcmp(name, "grep") == 0 && strlen(arg) < SHELL_PIPE_PATTERN_LENGTH)
+        {
+            shell->pipe.stage[shell->pipe.number].type = SHELL_PIPE_GREP;
+            strcpy(shell->pipe.stage[shell->pipe.number].pattern, arg);
+        }
+        else if (strcmp(name, "head") == 0)
+        {
+            shell->pipe.stage[shell->pipe.number].type = SHELL_PIPE_HEAD;
+            shell->pipe.stage[shell->pipe.number].max = 0;
+            for (char *p = arg; *p; p++)
+            {
+                if (*p < '0' || *p > '9')
+                {
+                    return -1;
+                }
+                shell->pipe.stage[shell->pipe.number].max =
+                    shell->pipe.stage[shell->pipe.number].max * 10 + *p - '0';
+            }
+        }
+        else
+        {
+            return -1;
+        }
+        shell->pipe.stage[shell->pipe.number].count = 0;
+        index += 3;
+        if (index < count && strcmp(shell->param[index], "|") != 0)
+        {
+            return -1;
+        }
+        shell->pipe.number++;
+    }
+    return 0;
+}
+#endif /** SHELL_USING_PIPE == 1 */
+
+
+/**
+ * @brief shell执行已解析的命令
+ * 
+ * @param shell shell对象
+ * @param paramCount 参数个数
+ * @param returnValue 命令返回值
+ * @return signed char 0 执行了命令函数 1 shell内部处理(help, 变量显示, 管道或重定向错误) -1 命令不存在
+ * 
+ * @note 使能管道时，命令输出经过管道过滤，管道中执行的命令(如脚本)不再解析管道
+ * @note 使能重定向时，命令输出写入`> [name]`指定的输出目标，命令结束后恢复之前的输出目标
+ */
+static signed char shellExecute(SHELL_TypeDef *shell, unsigned char paramCount, int *returnValue)
+{
+    signed char result;
+#if SHELL_USING_REDIRECT == 1
+    SHELL_SinkTypeDef *sink = shell->sink;
+
+    if (shellRedirectParse(shell, &paramCount) != 0)
+    {
+        shellDisplay(shell, shellText[TEXT_SINK_ERROR]);
+        return 1;
+    }
+#endif /** SHELL_USING_REDIRECT == 1 */
+#if SHELL_USING_PIPE == 1
+    if (shell->pipe.number > 0)
+    {
+        result = shellDispatch(shell, paramCount, returnValue);
+    }
+    else if (shellPipeParse(shell, &paramCount) != 0)
+    {
+        shell->pipe.number = 0;
+        shellDisplay(shell, shellText[TEXT_PIPE_ERROR]);
+        result = 1;
+    }
+    else
+    {
+        result = shellDispatch(shell, paramCount, returnValue);
+        if (shell->pipe.length > 0)
+        {
+            shellPipeLine(shell);
+        }
+        shell->pipe.number = 0;
+    }
+#else
+    result = shellDispatch(shell, paramCount, returnValue);
+#endif /** SHELL_USING_PIPE == 1 */
+#if SHELL_USING_REDIRECT == 1
+    shell->sink = sink;
+#endif /** SHELL_USING_REDIRECT == 1 */
+    return result;
+}
+
+
+/**
+ * @brief shell回车输入处理
+ * 
+ * @param shell shell对象
+ */
+static void shellEnter(SHELL_TypeDef *shell)
+{
+    unsigned char paramCount;
+#if SHELL_USING_ASYNC == 0
+    int returnValue;
+#endif /** SHELL_USING_ASYNC == 0 */
+
+#if SHELL_USING_AUTH == 1
+    if(shell->status.authFlag == 0)
+    {
+        if((shell->length != strlen(SHELL_USER_PASSWORD)) 
+            ||(strncmp(shell->buffer, SHELL_USER_PASSWORD, strlen(SHELL_USER_PASSWORD)) != 0))
+        {
+            shellDisplay(shell, shellText[TEXT_PWD_ERROR]);
+            shellDisplay(shell, shellText[TEXT_PWD_HINT]);
+        }
+        else
+        {
+            shell->status.authFlag = 1;
+            shellDisplay(shell, shellText[TEXT_PWD_RIGHT]);
+            shellDisplay(shell, shellText[TEXT_INFO]);
+            shellDisplay(shell, shell->command);
+        }
+
+        shell->length = 0; 
+        shell->cursor = 0;
+        return;
+    }
+#endif
+    
+    if (shell->length == 0)
+    {
+        shellDisplay(shell, shell->command);
+        return;
+    }
+    
+    *(shell->buffer + shell->length) = 0;
+    shellHistoryAdd(shell);
+
+    paramCount = shellParseParam(shell);
+    shell->length = 0;
+    shell->cursor = 0;
+    if (paramCount == 0)
+    {
+        shellDisplay(shell, shell->command);
+        return;
+    }
+
+    shellDisplay(shell, "\r\n");
+#if SHELL_USING_ASYNC == 1
+    shell->async.paramCount = paramCount;
+    shell->async.cancel = 0;
+    shell->async.pending = 1;
+    shell->async.busy = 1;
+    SHELL_ASYNC_NOTIFY(shell);
+#else
+    if (shellExecute(shell, paramCount, &returnValue) == 0)
+    {
+    #if SHELL_DISPLAY_RETURN == 1
+        shellDisplayReturn(shell, returnValue);
+    #endif /** SHELL_DISPLAY_RETURN == 1 */
+    }
+    shellDisplay(shell, shell->command);
+#endif /** SHELL_USING_ASYNC == 1 */
+}
+
+
+#if SHELL_USING_ASYNC == 1
+/**
+ * @brief shell异步输入缓冲写入
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ * @return int 0 缓冲已满
+ *             1 写入成功
+ * 
+ * @note 只在输入处理中调用，写入的数据需要提交后才会被读取
+ */
+static int shellAsyncPush(SHELL_TypeDef *shell, char data)
+{
+    unsigned short next = (shell->async.write + 1) % SHELL_ASYNC_INPUT_SIZE;
+
+    if (next == shell->async.tail)
+    {
+        return 0;
+    }
+    shell->async.input[shell->async.write] = data;
+    shell->async.write = next;
+    return 1;
+}
+
+
+/**
+ * @brief shell异步输入缓冲读取
+ * 
+ * @param shell shell对象
+ * @param data 读取的数据
+ * @return int 0 没有已提交的数据
+ *             1 读取成功
+ */
+static int shellAsyncPop(SHELL_TypeDef *shell, char *data)
+{
+    if (shell->async.tail == shell->async.head)
+    {
+        return 0;
+    }
+    *data = shell->async.input[shell->async.tail];
+    shell->async.tail = (shell->async.tail + 1) % SHELL_ASYNC_INPUT_SIZE;
+    return 1;
+}
+
+
+#if SHELL_USING_MACHINE == 1
+/**
+ * @brief shell机器模式命令执行期间的帧接收
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ * 
+ * @note 只识别帧边界，不写命令缓冲和帧序号，完整的帧提交到输入缓冲，命令结束后按顺序处理，
+ *       放不下的帧整帧丢弃，校验正确的取消请求立即设置取消标志
+ */
+static void shellAsyncFrame(SHELL_TypeDef *shell, char data)
+{
+    if (shell->async.frame.state == 0)
+    {
+        if ((unsigned char)data != SHELL_MACHINE_SOF)
+        {
+            return;
+        }
+        shell->async.frame.drop = 0;
+    }
+    if (!shell->async.frame.drop && !shellAsyncPush(shell, data))
+    {
+        shell->async.frame.drop = 1;
+    }
+    switch (shell->async.frame.state)
+    {
+    case 0:
+        shell->async.frame.state = 1;
+        break;
+    case 1:
+        shell->async.frame.type = data;
+        shell->async.frame.check = data;
+        shell->async.frame.state = 2;
+        break;
+    case 2:
+        shell->async.frame.check ^= data;
+        shell->async.frame.state = 3;
+        break;
+    case 3:
+        shell->async.frame.length = data;
+        shell->async.frame.check ^= data;
+        shell->async.frame.index = 0;
+        shell->async.frame.state = shell->async.frame.length ? 4 : 5;
+        break;
+    case 4:
+        shell->async.frame.check ^= data;
+        if (++shell->async.frame.index == shell->async.frame.length)
+        {
+            shell->async.frame.state = 5;
+        }
+        break;
+    default:
+        shell->async.frame.state = 0;
+        if (shell->async.frame.drop)
+        {
+            shell->async.write = shell->async.head;
+        }
+        else
+        {
+            shell->async.head = shell->async.write;
+        }
+        if (shell->async.frame.type == SHELL_MACHINE_CANCEL
+            && shell->async.frame.check == (unsigned char)data)
+        {
+            shell->async.cancel = 1;
+        }
+        break;
+    }
+}
+#endif /** SHELL_USING_MACHINE == 1 */
+
+
+/**
+ * @brief shell异步命令的输入处理
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ * @return int 0 输入需要立即处理
+ *             1 输入已缓存或作为取消请求处理
+ * 
+ * @note 命令执行期间`Ctrl+C`请求取消命令，机器模式下由取消请求帧代替，其他输入进入缓冲，
+ *       命令结束后由`shellAsyncRun()`处理，命令结束时留在缓冲中的输入在这里先处理
+ */
+static int shellAsyncInput(SHELL_TypeDef *shell, char data)
+{
+    char input;
+
+    if (!shell->async.busy)
+    {
+    #if SHELL_USING_MACHINE == 1
+        shell->async.frame.state = 0;
+    #endif /** SHELL_USING_MACHINE == 1 */
+        if (shell->async.write == shell->async.tail)
+        {
+            return 0;
+        }
+        shell->async.head = shell->async.write;
+        while (!shell->async.busy && shellAsyncPop(shell, &input))
+        {
+            shellInputData(shell, input);
+        }
+        if (!shell->async.busy)
+        {
+            return 0;
+        }
+    }
+#if SHELL_USING_MACHINE == 1
+    if (shell->status.machineMode)
+    {
+        shellAsyncFrame(shell, data);
+        return 1;
+    }
+#endif /** SHELL_USING_MACHINE == 1 */
+    if (data == SHELL_KEY_CTRL_C)
+    {
+        shell->async.cancel = 1;
+    }
+    else if (shellAsyncPush(shell, data))
+    {
+        shell->async.head = shell->async.write;
+    }
+    return 1;
+}
+
+
+/**
+ * @brief shell执行等待中的异步命令
+ * 
+ * @param shell shell对象
+ * @return int 0 没有等待执行的命令
+ *             1 命令执行完成
+ * 
+ * @note 在工作任务或主循环中调用，命令在调用者的上下文中执行，执行期间的输入先缓存，
+ *       命令结束后输出返回值和提示符，机器模式的请求执行结束后发送结果帧，
+ *       然后处理缓存的输入，其中的命令和请求同样在这里执行
+ */
+int shellAsyncRun(SHELL_TypeDef *shell)
+{
+    int returnValue;
+    char data;
+#if SHELL_USING_MACHINE == 1
+    unsigned char status;
+#endif /** SHELL_USING_MACHINE == 1 */
+
+    if (!shell->async.pending)
+    {
+        return 0;
+    }
+    do
+    {
+        shell->async.pending = 0;
+        returnValue = 0;
+    #if SHELL_USING_MACHINE == 1
+        if (shell->async.request)
+        {
+            status = shellMachineExecute(shell, shell->async.paramCount, &returnValue);
+            shellMachineResult(shell, status, returnValue);
+            shell->async.request = 0;
+        }
+        else
+    #endif /** SHELL_USING_MACHINE == 1 */
+        {
+            if (shellExecute(shell, shell->async.paramCount, &returnValue) == 0)
+            {
+            #if SHELL_DISPLAY_RETURN == 1
+                shellDisplayReturn(shell, returnValue);
+            #endif /** SHELL_DISPLAY_RETURN == 1 */
+            }
+            if (shell->async.cancel)
+            {
+                shellDisplay(shell, "^C\r\n");
+            }
+            shellDisplay(shell, shell->command);
+        }
+        shell->async.cancel = 0;
+        while (!shell->async.pending && shellAsyncPop(shell, &data))
+        {
+            shellInputData(shell, data);
+        }
+    } while (shell->async.pending);
+    shell->async.busy = 0;
+    return 1;
+}
+
+
+/**
+ * @brief 查询命令是否被取消
+ * 
+ * @param shell shell对象，命令中可使用`shellGetCurrent()`获取
+ * @return unsigned char 1 用户输入了`Ctrl+C`或收到取消请求帧，命令应尽快返回
+ *                       0 命令未被取消
+ * 
+ * @note 长时间运行的命令应在循环中周期性调用
+ */
+unsigned char shellCancelled(SHELL_TypeDef *shell)
+{
+    return shell ? shell->async.cancel : 0;
+}
+#endif /** SHELL_USING_ASYNC == 1 */
+
+
+/**
+ * @brief shell执行脚本
+ * 
+ * @param shell shell对象
+ * @param script 脚本，每行一条命令，以`#`开头的行为注释
+ * @param length 脚本长度，脚本在达到此长度或者遇到'\0'时结束
+ * @return int 0 脚本执行完成
+ *             其他 第一条返回非0的命令的返回值，命令不存在或命令过长时返回-1
+ * 
+ * @note 脚本逐行复制到命令缓冲后执行，不回显，不记录历史，不输出提示符和返回值，
+ *       因此脚本可以存放在flash等只读存储中
+ * @note 脚本执行会使用命令缓冲，不应在用户输入命令的过程中调用
+ */
+int shellExecScript(SHELL_TypeDef *shell, const char *script, unsigned int length)
+{
+    unsigned int index = 0;
+    unsigned short lineLength;
+    unsigned char paramCount;
+    int returnValue;
+
+    shell->length = 0;
+    shell->cursor = 0;
+    while (index < length && script[index])
+    {
+        lineLength = 0;
+        while (index < length && script[index]
+               && script[index] != '\r' && script[index] != '\n')
+        {
+            if (lineLength >= SHELL_COMMAND_MAX_LENGTH - 1)
+            {
+                shellDisplay(shell, shellText[TEXT_CMD_TOO_LONG]);
+                return -1;
+            }
+            shell->buffer[lineLength++] = script[index++];
+        }
+        while (index < length && (script[index] == '\r' || script[index] == '\n'))
+        {
+            index++;
+        }
+        shell->buffer[lineLength] = 0;
+
+        paramCount = shellParseParam(shell);
+        if (paramCount == 0 || shell->param[0][0] == '#')
+        {
+            continue;
+        }
+    #if SHELL_USING_ASYNC == 1
+        if (shell->async.cancel)
+        {
+            return -1;
+        }
+    #endif /** SHELL_USING_ASYNC == 1 */
+        switch (shellExecute(shell, paramCount, &returnValue))
+        {
+        case -1:
+            return -1;
+        case 0:
+            if (returnValue != 0)
+            {
+                return returnValue;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief shell退格输入处理
+ * 
+ * @param shell shell对象
+ */
+static void shellBackspace(SHELL_TypeDef *shell)
+{
+    if (shell->length == 0)
+    {
+        return;
+    }
+    if (shell->cursor == shell->length)
+    {
+        shell->length--;
+        shell->cursor--;
+        shell->buffer[shell->length] = 0;
+        shellDelete(shell, 1);
+    }
+    else if (shell->cursor > 0)
+    {
+        for (short i = 0; i < shell->length - shell->cursor; i++)
+        {
+            shell->buffer[shell->cursor + i - 1] = shell->buffer[shell->cursor + i];
+        }
+        shell->length--;
+        shell->cursor--;
+        shell->buffer[shell->length] = 0;
+    #if SHELL_ANSI_EDIT == 1
+        shellWriteData(shell, "\b\033[P", 4);
+    #else
+        shellDisplayByte(shell, '\b');
+        shellWriteData(shell, shell->buffer + shell->cursor, shell->length - shell->cursor);
+        shellDisplayByte(shell, ' ');
+        shellDisplayRepeat(shell, '\b', shell->length - shell->cursor + 1);
+    #endif /** SHELL_ANSI_EDIT == 1 */
+    }
+}
+
+
+/**
+ * @brief shell Tab键输入处理
+ * 
+ * @param shell shell对象
+ */
+static void shellTab(SHELL_TypeDef *shell)
+{
+    unsigned short maxMatch = SHELL_COMMAND_MAX_LENGTH;
+    SHELL_CommandTypeDef *lastMatch = NULL;
+    unsigned short matchNum = 0;
+    unsigned short first;
+    unsigned short length;
+    SHELL_CommandTypeDef *base = shell->commandBase;
+    unsigned char ordered;
+
+#if SHELL_USING_AUTH == 1
+    if (!shell->status.authFlag)
+    {
+        return;
+    }
+#endif
+
+    if (shell->length != 0)
+    {
+        shell->buffer[shell->length] = 0;
+    #if SHELL_USING_REGISTRY == 1
+        SHELL_LIST_LOCK();
+        shellRegistrySync(shell);
+    #endif /** SHELL_USING_REGISTRY == 1 */
+        ordered = shellCommandOrdered(shell);
+        if (ordered)
+        {
+            matchNum = shellCommandRange(shell, shell->buffer, shell->length, &first);
+            if (matchNum != 0)
+            {
+                lastMatch = shellOrderedCommand(shell, first + matchNum - 1);
+                maxMatch = shellStringCompare((char *)shellOrderedCommand(shell, first)->name,
+                                              (char *)lastMatch->name);
+            }
+        }
+    #if SHELL_USING_REGISTRY == 1
+        SHELL_LIST_UNLOCK();
+    #endif /** SHELL_USING_REGISTRY == 1 */
+        if (ordered)
+        {
+            /* 候选列表在锁外输出，期间注册的命令只影响列表，不影响补全结果 */
+            if (matchNum > 1)
+            {
+                shellDisplay(shell, "\r\n");
+                for (unsigned short i = first; i < first + matchNum - 1; i++)
+                {
+                    shellDisplayItem(shell, shellOrderedCommand(shell, i));
+                }
+            }
+        }
+        else
+        {
+            for (unsigned short i = 0; i < shell->commandNumber; i++)
+            {
+                if (shellStringCompare(shell->buffer, 
+                    (char *)shellCommandAt(base, i)->name)
+                    == shell->length)
+                {
+                    if (matchNum != 0)
+                    {
+                        if (matchNum == 1)
+                        {
+                            shellDisplay(shell, "\r\n");
+                        }
+                        shellDisplayItem(shell, lastMatch);
+                        length = shellStringCompare((char *)lastMatch->name,
+                                                    (char *)shellCommandAt(base, i)->name);
+                        maxMatch = (maxMatch > length) ? length : maxMatch;
+                    }
+                    lastMatch = shellCommandAt(base, i);
+                    matchNum ++;
+                }
+            }
+        }
+
+        if (matchNum == 0)
+        {
+            return;
+        }
+        if (matchNum == 1)
+        {
+            shellClearLine(shell);
+        }
+        if (matchNum != 0)
+        {
+            shell->length = shellStringCopy(shell->buffer, (char *)lastMatch->name);
+        }
+        if (matchNum > 1)
+        {
+            shellDisplayItem(shell, lastMatch);
+            shellDisplay(shell, shell->command);
+            shell->length = maxMatch;
+        }
+        shell->buffer[shell->length] = 0;
+        shell->cursor = shell->length;
+        shellDisplay(shell, shell->buffer);
+    }
+    else
+    {
+        shellShowHelp(shell, 1, (void *)0);
+        shellDisplay(shell, shell->command);
+    }
+
+#if SHELL_LONG_HELP == 1
+    if (SHELL_GET_TICK())
+    {
+        if (matchNum == 1
+            && shell->status.tabFlag == 1
+            && SHELL_GET_TICK() - shell->activeTime < SHELL_DOUBLE_CLICK_TIME)
+        {
+            shellClearLine(shell);
+            for (short i = shell->length; i >= 0; i--)
+            {
+                shell->buffer[i + 5] = shell->buffer[i];
+            }
+            shellStringCopy(shell->buffer, "help");
+            shell->buffer[4] = ' ';
+            shell->length += 5;
+            shell->cursor = shell->length;
+            shellDisplay(shell, shell->buffer);
+        }
+    }
+#endif /** SHELL_LONG_HELP == 1 */
+}
+
+
+/**
+ * @brief shell正常按键处理
+ * 
+ * @param shell shell对象
+ * @param data 输入的数据
+ */
+static void shellNormal(SHELL_TypeDef *shell, char data)
+{
+    if (data == 0)
+    {
+        return;
+    }
+    if (shell->length < SHELL_COMMAND_MAX_LENGTH - 1)
+    {
+        if (shell->length == shell->cursor)
+        {
+            shell->buffer[shell->length++] = data;
+            shell->cursor++;
+            shellDisplayByte(shell, data);
+        }
+        else
+        {
+            for (short i = shell->length - shell->cursor; i > 0; i--)
+            {
+                shell->buffer[shell->cursor + i] = shell->buffer[shell->cursor + i - 1];
+            }
+            shell->buffer[shell->cursor++] = data;
+            shell->buffer[++shell->length] = 0;
+        #if SHELL_ANSI_EDIT == 1
+            char sequence[4] = {SHELL_KEY_ESC, '[', '@', data};
+            shellWriteData(shell, sequence, 4);
+        #else
+            shellWriteData(shell, shell->buffer + shell->cursor - 1,
+                           shell->length - shell->cursor + 1);
+            shellDisplayRepeat(shell, '\b', shell->length - shell->cursor);
+        #endif /** SHELL_ANSI_EDIT == 1 */
+        }
+    }
+    else
+    {
+        shellDisplay(shell, shellText[TEXT_CMD_TOO_LONG]);
+        shellDisplay(shell, shell->command);
+        shellDisplay(shell, shell->buffer);
+        shell->cursor = shell->length;
+    }
+}
+
+
+/**
+ * @brief shell移动光标
+ * 
+ * @param shell shell对象
+ * @param position 光标目标位置
+ */
+static void shellCursorMove(SHELL_TypeDef *shell, unsigned short position)
+{
+    if (position > shell->length)
+    {
+        position = shell->length;
+    }
+#if SHELL_ANSI_EDIT == 1
+    char buffer[8];
+#endif
+
+    if (position < shell->cursor)
+    {
+    #if SHELL_ANSI_EDIT == 1
+        shellWriteData(shell, buffer, shellCursorBackFormat(buffer, shell->cursor - position));
+    #else
+        shellDisplayRepeat(shell, '\b', shell->cursor - position);
+    #endif /** SHELL_ANSI_EDIT == 1 */
+    }
+#if SHELL_ANSI_EDIT == 1
+    else if (position > shell->cursor + 3)
+    {
+        shellWriteData(shell, buffer, shellCsiFormat(buffer, position - shell->cursor, 'C'));
+    }
+#endif /** SHELL_ANSI_EDIT == 1 */
+    else if (position > shell->cursor)
+    {
+        shellWriteData(shell, shell->buffer + shell->cursor, position - shell->cursor);
+    }
+    shell->cursor = position;
+}
+
+
+/**
+ * @brief shell光标左移
+ * 
+ * @param shell shell对象
+ * 
+ * @note 带修饰键(ctrl, alt)时，光标移动到前一个单词开头
+ */
+static void shellCursorLeft(SHELL_TypeDef *shell)
+{
+    unsigned short position = shell->cursor;
+
+    if (shell->ansi.paramCount < 2 || shell->ansi.param[1] <= 2)
+    {
+        shellCursorMove(shell, (position > 0) ? position - 1 : 0);
+        return;
+    }
+    while (position > 0 && shell->buffer[position - 1] == ' ')
+    {
+        position--;
+    }
+    while (position > 0 && shell->buffer[position - 1] != ' ')
+    {
+        position--;
+    }
+    shellCursorMove(shell, position);
+}
+
+
+/**
+ * @brief shell光标右移
+ * 
+ * @param shell shell对象
+ * 
+ * @note 带修饰键(ctrl, alt)时，光标移动到后一个单词末尾
+ */
+static void shellCursorRight(SHELL_TypeDef *shell)
+{
+    unsigned short position = shell->cursor;
+
+    if (shell->ansi.paramCount < 2 || shell->ansi.param[1] <= 2)
+    {
+        shellCursorMove(shell, position + 1);
+        return;
+    }
+    while (position < shell->length && shell->buffer[position] == ' ')
+    {
+        position++;
+    }
+    while (position < shell->length && shell->buffer[position] != ' ')
+    {
+        position++;
+    }
+    shellCursorMove(shell, position);
+}
+
+
+/**
+ * @brief shell光标移动到行首
+ * 
+ * @param shell shell对象
+ */
+static void shellCursorHome(SHELL_TypeDef *shell)
+{
+    shellCursorMove(shell, 0);
+}
+
+
+/**
+ * @brief shell光标移动到行尾
+ * 
+ * @param shell shell对象
+ */
+static void shellCursorEnd(SHELL_TypeDef *shell)
+{
+    shellCursorMove(shell, shell->length);
+}
+
+
+/**
+ * @brief shell上一条历史记录
+ * 
+ * @param shell shell对象
+ */
+static void shellHistoryUp(SHELL_TypeDef *shell)
+{
+    shellHistory(shell, 0);
+}
+
+
+/**
+ * @brief shell下一条历史记录
+ * 
+ * @param shell shell对象
+ */
+static void shellHistoryDown(SHELL_TypeDef *shell)
+{
+    shellHistory(shell, 1);
+}
+
+
+/**
+ * @brief shell删除光标处字符
+ * 
+ * @param shell shell对象
+ */
+static void shellDeleteKey(SHELL_TypeDef *shell)
+{
+    if (shell->cursor >= shell->length)
+    {
+        return;
+    }
+    for (unsigned short i = shell->cursor; i < shell->length - 1; i++)
+    {
+        shell->buffer[i] = shell->buffer[i + 1];
+    }
+    shell->length--;
+    shell->buffer[shell->length] = 0;
+#if SHELL_ANSI_EDIT == 1
+    shellWriteData(shell, "\033[P", 3);
+#else
+    shellWriteData(shell, shell->buffer + shell->cursor, shell->length - shell->cursor);
+    shellDisplayByte(shell, ' ');
+    shellDisplayRepeat(shell, '\b', shell->length - shell->cursor + 1);
+#endif /** SHELL_ANSI_EDIT == 1 */
+}
+
+
+/**
+ * @brief shell ansi控制序列响应定义
+ * 
+ */
+typedef struct
+{
+    unsigned char finalCode;                                    /**< 控制序列结束字符 */
+    unsigned char param;                                        /**< 控制序列第一个参数，0表示任意 */
+    void (*function)(SHELL_TypeDef *);                          /**< 响应函数 */
+} SHELL_AnsiFunctionDef;
+
+
+/**
+ * @brief ansi控制序列响应表
+ * 
+ * @note CSI(ESC [)与SS3(ESC O)序列共用此表
+ */
+static const SHELL_AnsiFunctionDef shellAnsiFunctionList[] =
+{
+    {'A',   0,  shellHistoryUp},                                /** 方向上键 */
+    {'B',   0,  shellHistoryDown},                              /** 方向下键 */
+    {'C',   0,  shellCursorRight},                              /** 方向右键 */
+    {'D',   0,  shellCursorLeft},                               /** 方向左键 */
+    {'H',   0,  shellCursorHome},                               /** home键 */
+    {'F',   0,  shellCursorEnd},                                /** end键 */
+    {'~',   1,  shellCursorHome},                               /** home键 */
+    {'~',   7,  shellCursorHome},                               /** home键 */
+    {'~',   3,  shellDeleteKey},                                /** delete键 */
+    {'~',   4,  shellCursorEnd},                                /** end键 */
+    {'~',   8,  shellCursorEnd},                                /** end键 */
+#if SHELL_USING_MACHINE == 1
+    {'~',   99, shellMachineStart},                             /** 进入机器模式 */
+#endif /** SHELL_USING_MACHINE == 1 */
+};
+
+
+/**
+ * @brief shell开始ansi控制序列
+ * 
+ * @param shell shell对象
+ */
+static void shellAnsiStart(SHELL_TypeDef *shell)
+{
+    shell->status.inputMode = SHELL_ANSI_ESC;
+}
+
+
+/**
+ * @brief shell ansi控制序列分发
+ * 
+ * @param shell shell对象
+ * @param finalCode 控制序列结束字符
+ */
+static void shellAnsiDispatch(SHELL_TypeDef *shell, char finalCode)
+{
+    unsigned char param = shell->ansi.paramCount ? shell->ansi.param[0] : 0;
+
+    for (unsigned short i = 0;
+         i < sizeof(shellAnsiFunctionList) / sizeof(SHELL_AnsiFunctionDef);
+         i++)
+    {
+        if (shellAnsiFunctionList[i].finalCode == (unsigned char)finalCode
+            && (shellAnsiFunctionList[i].param == 0
+                || shellAnsiFunctionList[i].param == param))
+        {
+            shellAnsiFunctionList[i].function(shell);
+            return;
+        }
+    }
+}
+
+
+/**
+ * @brief shell ansi控制序列处理
+ * 
+ * @param shell shell对象
+ * @param data 输入的数据
+ * 
+ * @note 支持CSI序列(ESC [ 参数 结束字符)，SS3序列(ESC O 结束字符)以及alt+b，alt+f，
+ *       不支持的序列会被完整丢弃
+ */
+void shellAnsi(SHELL_TypeDef *shell, char data)
+{
+    switch ((unsigned char)(shell->status.inputMode))
+    {
+    case SHELL_ANSI_CSI:
+        if (data >= '0' && data <= '9')
+        {
+            if (shell->ansi.paramCount == 0)
+            {
+                shell->ansi.paramCount = 1;
+            }
+            if (shell->ansi.paramCount <= SHELL_ANSI_PARAM_NUMBER)
+            {
+                unsigned short param = shell->ansi.param[shell->ansi.paramCount - 1] * 10
+                                       + data - '0';
+                shell->ansi.param[shell->ansi.paramCount - 1] = (param > 255) ? 255 : param;
+            }
+        }
+        else if (data == ';')
+        {
+            if (shell->ansi.paramCount == 0)
+            {
+                shell->ansi.paramCount = 1;
+            }
+            if (shell->ansi.paramCount <= SHELL_ANSI_PARAM_NUMBER)
+            {
+                if (++shell->ansi.paramCount <= SHELL_ANSI_PARAM_NUMBER)
+                {
+                    shell->ansi.param[shell->ansi.paramCount - 1] = 0;
+                }
+            }
+        }
+        else if (data >= 0x40 && data <= 0x7E)
+        {
+            shellAnsiDispatch(shell, data);
+            shell->status.inputMode = SHELL_IN_NORMAL;
+        }
+        else if (data < 0x20 || data > 0x3F)
+        {
+            shell->status.inputMode = SHELL_IN_NORMAL;
+        }
+        break;
+
+    case SHELL_ANSI_SS3:
+        shell->ansi.paramCount = 0;
+        shellAnsiDispatch(shell, data);
+        shell->status.inputMode = SHELL_IN_NORMAL;
+        break;
+
+    case SHELL_ANSI_ESC:
+        shell->ansi.paramCount = 0;
+        shell->ansi.param[0] = 0;
+        if (data == 0x5B)
+        {
+            shell->status.inputMode = SHELL_ANSI_CSI;
+        }
+        else if (data == 'O')
+        {
+            shell->status.inputMode = SHELL_ANSI_SS3;
+        }
+        else
+        {
+            if (data == 'b' || data == 'f')
+            {
+                shell->ansi.paramCount = 2;
+                shell->ansi.param[1] = 3;
+                if (data == 'b')
+                {
+                    shellCursorLeft(shell);
+                }
+                else
+                {
+                    shellCursorRight(shell);
+                }
+            }
+            shell->status.inputMode = SHELL_IN_NORMAL;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+#if SHELL_USING_MACHINE == 1
+/**
+ * @brief shell设置机器模式
+ * 
+ * @param shell shell对象
+ * @param enable 1 进入机器模式 0 退出机器模式
+ * 
+ * @note 进入机器模式后，shell发送一个序号为0的结果帧，退出后重新输出提示符
+ */
+void shellSetMachineMode(SHELL_TypeDef *shell, unsigned char enable)
+{
+    shell->length = 0;
+    shell->cursor = 0;
+    shell->status.inputMode = SHELL_IN_NORMAL;
+    shell->machine.state = 0;
+    shell->machine.seq = 0;
+    if (enable)
+    {
+        shell->status.machineMode = 1;
+        shellMachineResult(shell, SHELL_MACHINE_OK, 0);
+    }
+    else
+    {
+        shell->status.machineMode = 0;
+        shellDisplay(shell, shell->command);
+    }
+}
+
+
+/**
+ * @brief shell通过控制序列进入机器模式
+ * 
+ * @param shell shell对象
+ */
+static void shellMachineStart(SHELL_TypeDef *shell)
+{
+#if SHELL_USING_AUTH == 1
+    if (shell->status.authFlag == 0)
+    {
+        return;
+    }
+#endif
+    shellSetMachineMode(shell, 1);
+}
+
+
+#if SHELL_AUTO_PRASE == 1
+/**
+ * @brief shell机器模式发送命令表
+ * 
+ * @param shell shell对象
+ * 
+ * @note 每条命令发送一个条目帧，数据为2字节小端序命令索引，命令名，'\0'以及参数签名
+ */
+static void shellMachineList(SHELL_TypeDef *shell)
+{
+    char entry[SHELL_MACHINE_DATA_SIZE];
+    unsigned char length;
+    const char *p;
+
+    for (unsigned short i = 0; i < shell->commandNumber; i++)
+    {
+        entry[0] = (char)i;
+        entry[1] = (char)(i >> 8);
+        length = 2;
+        for (p = shellCommandAt(shell->commandBase, i)->name; *p && length < sizeof(entry) - 1; p++)
+        {
+            entry[length++] = *p;
+        }
+        entry[length++] = 0;
+    #if SHELL_TYPED_COMMAND == 1
+        for (p = shellCommandAt(shell->commandBase, i)->signature;
+             p && *p && length < sizeof(entry); p++)
+        {
+            entry[length++] = *p;
+        }
+    #endif /** SHELL_TYPED_COMMAND == 1 */
+        shellMachineFrame(shell, SHELL_MACHINE_ENTRY, entry, length);
+    }
+}
+
+
+/**
+ * @brief shell机器模式按索引调用命令
+ * 
+ * @param shell shell对象
+ * @param returnValue 命令返回值
+ * @return unsigned char 执行状态
+ * 
+ * @note 请求数据为2字节小端序命令索引，以及若干4字节小端序参数，
+ *       参数直接传递给命令函数，不进行命令查找和参数解析
+ */
+static unsigned char shellMachineInvoke(SHELL_TypeDef *shell, int *returnValue)
+{
+    unsigned char *data = (unsigned char *)shell->buffer;
+    size_t value[SHELL_PARAMETER_MAX_NUMBER - 1];
+    unsigned short index;
+    unsigned char count;
+    SHELL_TypeDef *last;
+    SHELL_CommandTypeDef *command;
+
+    if (shell->machine.length < 2 || (shell->machine.length - 2) % 4 != 0
+        || (count = (shell->machine.length - 2) / 4) > SHELL_PARAMETER_MAX_NUMBER - 1)
+    {
+        return SHELL_MACHINE_PARAM_ERROR;
+    }
+    index = data[0] | (data[1] << 8);
+    if (index >= shell->commandNumber)
+    {
+        return SHELL_MACHINE_NOT_FOUND;
+    }
+    command = shellCommandAt(shell->commandBase, index);
+    for (unsigned char i = 0; i < count; i++)
+    {
+        value[i] = data[2 + i * 4] | (data[3 + i * 4] << 8)
+                   | (data[4 + i * 4] << 16) | ((unsigned int)data[5 + i * 4] << 24);
+    }
+
+    last = shellSetCurrent(shell);
+#if SHELL_TYPED_COMMAND == 1
+    if (command->signature)
+    {
+        if (shellExtCallTyped(command->signature, command->function,
+                              count, value, returnValue) != 0)
+        {
+            shellSetCurrent(last);
+            return SHELL_MACHINE_PARAM_ERROR;
+        }
+    }
+    else
+#endif /** SHELL_TYPED_COMMAND == 1 */
+    {
+        *returnValue = shellExtCall(command->function, count, value);
+    }
+    shellSetCurrent(last);
+    return SHELL_MACHINE_OK;
+}
+#endif /** SHELL_AUTO_PRASE == 1 */
+
+
+/**
+ * @brief shell机器模式执行请求
+ * 
+ * @param shell shell对象
+ * @param paramCount 执行命令请求的参数个数
+ * @param returnValue 命令返回值
+ * @return unsigned char 执行状态
+ */
+static unsigned char shellMachineExecute(SHELL_TypeDef *shell, unsigned char paramCount,
+                                         int *returnValue)
+{
+#if SHELL_AUTO_PRASE == 1
+    if (shell->machine.type == SHELL_MACHINE_INVOKE)
+    {
+        return shellMachineInvoke(shell, returnValue);
+    }
+#endif /** SHELL_AUTO_PRASE == 1 */
+    if (paramCount > 0 && shellExecute(shell, paramCount, returnValue) < 0)
+    {
+        return SHELL_MACHINE_NOT_FOUND;
+    }
+    return SHELL_MACHINE_OK;
+}
+
+
+/**
+ * @brief shell机器模式请求处理
+ * 
+ * @param shell shell对象
+ * @param check 帧校验值
+ * 
+ * @note 使用异步命令时，执行命令和按索引调用的请求交给`shellAsyncRun()`执行，
+ *       执行结束后发送结果帧
+ */
+static void shellMachineRequest(SHELL_TypeDef *shell, unsigned char check)
+{
+    unsigned char status = SHELL_MACHINE_OK;
+    unsigned char paramCount;
+    int returnValue = 0;
+
+    if (check != shell->machine.check)
+    {
+        status = SHELL_MACHINE_CHECK_ERROR;
+    }
+    else if (shell->machine.length >= SHELL_COMMAND_MAX_LENGTH)
+    {
+        status = SHELL_MACHINE_TOO_LONG;
+    }
+    else if (shell->machine.type == SHELL_MACHINE_COMMAND
+    #if SHELL_AUTO_PRASE == 1
+             || shell->machine.type == SHELL_MACHINE_INVOKE
+    #endif /** SHELL_AUTO_PRASE == 1 */
+            )
+    {
+        paramCount = 0;
+        if (shell->machine.type == SHELL_MACHINE_COMMAND)
+        {
+            shell->buffer[shell->machine.length] = 0;
+            paramCount = shellParseParam(shell);
+        }
+    #if SHELL_USING_ASYNC == 1
+        shell->async.paramCount = paramCount;
+        shell->async.request = shell->machine.type;
+        shell->async.cancel = 0;
+        shell->async.pending = 1;
+        shell->async.busy = 1;
+        SHELL_ASYNC_NOTIFY(shell);
+        return;
+    #else
+        status = shellMachineExecute(shell, paramCount, &returnValue);
+    #endif /** SHELL_USING_ASYNC == 1 */
+    }
+#if SHELL_AUTO_PRASE == 1
+    else if (shell->machine.type == SHELL_MACHINE_LIST)
+    {
+        shellMachineList(shell);
+        returnValue = shell->commandNumber;
+    }
+#endif /** SHELL_AUTO_PRASE == 1 */
+    else if (shell->machine.type == SHELL_MACHINE_CANCEL)
+    {
+        /** 取消请求在命令执行期间生效，这里只回复结果 */
+    }
+    else if (shell->machine.type == SHELL_MACHINE_EXIT)
+    {
+        shellMachineResult(shell, SHELL_MACHINE_OK, 0);
+        shellSetMachineMode(shell, 0);
+        return;
+    }
+    else
+    {
+        status = SHELL_MACHINE_UNKNOWN;
+    }
+    shellMachineResult(shell, status, returnValue);
+}
+
+
+/**
+ * @brief shell机器模式输入处理
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ * 
+ * @note 帧起始之前的数据会被丢弃，数据超出命令缓冲的部分不保存，收到完整帧后返回命令过长
+ */
+static void shellMachineInput(SHELL_TypeDef *shell, char data)
+{
+    switch (shell->machine.state)
+    {
+    case 0:
+        if ((unsigned char)data == SHELL_MACHINE_SOF)
+        {
+            shell->machine.state = 1;
+        }
+        break;
+    case 1:
+        shell->machine.type = data;
+        shell->machine.check = data;
+        shell->machine.state = 2;
+        break;
+    case 2:
+        shell->machine.seq = data;
+        shell->machine.check ^= data;
+        shell->machine.state = 3;
+        break;
+    case 3:
+        shell->machine.length = data;
+        shell->machine.check ^= data;
+        shell->machine.index = 0;
+        shell->machine.state = shell->machine.length ? 4 : 5;
+        break;
+    case 4:
+        if (shell->machine.index < SHELL_COMMAND_MAX_LENGTH - 1)
+        {
+            shell->buffer[shell->machine.index] = data;
+        }
+        shell->machine.check ^= data;
+        if (++shell->machine.index == shell->machine.length)
+        {
+            shell->machine.state = 5;
+        }
+        break;
+    default:
+        shell->machine.state = 0;
+        shellMachineRequest(shell, data);
+        break;
+    }
+}
+#endif /** SHELL_USING_MACHINE == 1 */
+
+
+/**
+ * @brief shell输入数据分发
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ */
+static void shellInputData(SHELL_TypeDef *shell, char data)
+{
+    const SHELL_KeyFunctionDef *key;
+
+#if SHELL_USING_MACHINE == 1
+    if (shell->status.machineMode)
+    {
+        shellMachineInput(shell, data);
+        return;
+    }
+#endif /** SHELL_USING_MACHINE == 1 */
+#if SHELL_HISTORY_SEARCH == 1
+    if (shell->status.searchMode && shellSearchInput(shell, data) == 0)
+    {
+        return;
+    }
+#endif /** SHELL_HISTORY_SEARCH == 1 */
+    if (shell->status.inputMode == SHELL_IN_NORMAL)
+    {
+        key = shellSeekKey(shell, data);
+        if (key)
+        {
+            if (key->keyFunction)
+            {
+                key->keyFunction(shell);
+            }
+        }
+        else
+        {
+            shellNormal(shell, data);
+        }
+    }
+    else
+    {
+        shellAnsi(shell, data);
+    }
+}
+
+
+/**
+ * @brief shell输入数据处理
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ */
+static void shellProcess(SHELL_TypeDef *shell, char data)
+{
+#if SHELL_USING_ASYNC == 1
+    if (shellAsyncInput(shell, data))
+    {
+        return;
+    }
+#endif /** SHELL_USING_ASYNC == 1 */
+    shellInputData(shell, data);
+}
+
+
+/**
+ * @brief shell处理
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ */
+void shellHandler(SHELL_TypeDef *shell, char data)
+{
+#if SHELL_USING_REGISTRY == 1 || SHELL_INIT_DEFERRED == 1
+    shellInputPrepare(shell);
+#endif /** SHELL_USING_REGISTRY == 1 || SHELL_INIT_DEFERRED == 1 */
+#if SHELL_USING_AUTH == 1 && SHELL_LOCK_TIMEOUT > 0
+    if (SHELL_GET_TICK())
+    {
+        if (SHELL_GET_TICK() - shell->activeTime > SHELL_LOCK_TIMEOUT)
+        {
+            shell->status.authFlag = 0;
+        }
+    }
+#endif
+    shellProcess(shell, data);
+#if SHELL_LONG_HELP == 1 || (SHELL_USING_AUTH && SHELL_LOCK_TIMEOUT > 0)
+    if (SHELL_GET_TICK())
+    {
+        shell->activeTime = SHELL_GET_TICK();
+    }
+#endif
+#if SHELL_LONG_HELP == 1
+    shell->status.tabFlag = data == '\t' ? 1 : 0;
+#endif
+}
+
+
+/**
+ * @brief shell获取可直接输入的字符长度
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ * @param length 数据长度
+ * @return unsigned short 从数据开始，可直接追加到命令缓冲的普通字符数量
+ * 
+ * @note 普通字符为没有按键响应的可打印字符，只有光标在命令末尾时才直接追加
+ */
+static unsigned short shellPlainLength(SHELL_TypeDef *shell, const char *data, unsigned short length)
+{
+    unsigned short space;
+    unsigned short count = 0;
+
+    if (shell->status.inputMode != SHELL_IN_NORMAL || shell->cursor != shell->length
+        || shell->status.machineMode || shell->status.searchMode)
+    {
+        return 0;
+    }
+#if SHELL_USING_ASYNC == 1
+    if (shell->async.busy || shell->async.write != shell->async.tail)
+    {
+        return 0;
+    }
+#endif /** SHELL_USING_ASYNC == 1 */
+    space = SHELL_COMMAND_MAX_LENGTH - 1 - shell->length;
+    length = (length > space) ? space : length;
+    while (count < length)
+    {
+        if ((unsigned char)data[count] < 0x20 || data[count] == SHELL_KEY_DELETE)
+        {
+            break;
+        }
+        if (shell->keyFuncNumber != 0 && shellSeekKey(shell, data[count]))
+        {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+
+/**
+ * @brief shell批量处理
+ * 
+ * @param shell shell对象
+ * @param data 输入数据
+ * @param length 数据长度
+ * 
+ * @note 用于一次接收到多个字节的情况(如DMA，网络)，连续的普通字符直接拷贝到命令缓冲，
+ *       并一次回显，系统时间每次调用只获取一次
+ */
+void shellHandlerBuffer(SHELL_TypeDef *shell, const char *data, unsigned short length)
+{
+    unsigned short count;
+#if SHELL_LONG_HELP == 1 || (SHELL_USING_AUTH && SHELL_LOCK_TIMEOUT > 0)
+    int tick = SHELL_GET_TICK();
+#endif
+
+#if SHELL_USING_REGISTRY == 1 || SHELL_INIT_DEFERRED == 1
+    shellInputPrepare(shell);
+#endif /** SHELL_USING_REGISTRY == 1 || SHELL_INIT_DEFERRED == 1 */
+#if SHELL_USING_AUTH == 1 && SHELL_LOCK_TIMEOUT > 0
+    if (tick && tick - shell->activeTime > SHELL_LOCK_TIMEOUT)
+    {
+        shell->status.authFlag = 0;
+    }
+#endif
+    while (length)
+    {
+        count = shellPlainLength(shell, data, length);
+        if (count > 0)
+        {
+            memcpy(shell->buffer + shell->length, data, count);
+            shell->length += count;
+            shell->cursor += count;
+            shellWriteData(shell, data, count);
+        #if SHELL_LONG_HELP == 1
+            shell->status.tabFlag = 0;
+        #endif
+        }
+        else
+        {
+            count = 1;
+            shellProcess(shell, *data);
+        #if SHELL_LONG_HELP == 1 || (SHELL_USING_AUTH && SHELL_LOCK_TIMEOUT > 0)
+            if (tick)
+            {
+                shell->activeTime = tick;
+            }
+        #endif
+        #if SHELL_LONG_HELP == 1
+            shell->status.tabFlag = *data == '\t' ? 1 : 0;
+        #endif
+        }
+        data += count;
+        length -= count;
+    }
+#if SHELL_LONG_HELP == 1 || (SHELL_USING_AUTH && SHELL_LOCK_TIMEOUT > 0)
+    if (tick)
+    {
+        shell->activeTime = tick;
+    }
+#endif
+}
+
+
+#if SHELL_USING_TASK == 1
+/**
+ * @brief shell 任务
+ * 
+ * @param param shell对象
+ * 
+ * @note 使用操作系统时，定义的shell read函数必须是阻塞式的
+ * @note 定义了`shell->readBuffer`时优先使用块读，整块数据交给`shellInputBuffer()`处理，
+ *       相比逐字节读取可以减少任务切换和函数调用的开销
+ * @note 不使用操作系统时，可以通过不断查询的方式使用shell，修改宏SHELL_TASK_WHILE
+ *       为0，然后在主循环中不断调用此函数
+ */
+void shellTask(void *param)
+{
+    SHELL_TypeDef *shell = (SHELL_TypeDef *)param;
+    char data[SHELL_READ_BUFFER_SIZE];
     unsigned short length;
-    SHELL_CommandTypeDef *base = shell->commandBase;
+    if (shell->read == NULL && shell->readBuffer == NULL)
+    {
+        shellDisplay(shell, shellText[TEXT_READ_NOT_DEF]);
+        while (1) ;
+    }
+#if SHELL_TASK_WHILE == 1
+    while (1)
+    {
+#endif
+        if (shell->readBuffer)
+        {
+            length = shell->readBuffer(data, SHELL_READ_BUFFER_SIZE);
+            if (length > 0)
+            {
+                shellInputBuffer(shell, data, length);
+            }
+        }
+        else if (shell->read(data) == 0)
+        {
+            shellInput(shell, *data);
+        }
+#if SHELL_TASK_WHILE == 1
+    }
+#endif
+}
+#endif
 
-#if SHELL_USING_AUTH == 1
-    if (!shell->status.authFlag)
+
+#if SHELL_USING_VAR == 1
+#if SHELL_VARIABLE_INDEX_MAX > 0
+/**
+ * @brief shell变量排序比较
+ * 
+ * @param base 变量表基址
+ * @param a 变量下标
+ * @param b 变量下标
+ * @return int 比较结果，变量名相同时按下标比较
+ */
+static int shellVariableIndexCompare(SHELL_VaribaleTypeDef *base,
+                                     unsigned short a, unsigned short b)
+{
+    int result = strcmp((base + a)->name, (base + b)->name);
+    return (result != 0) ? result : (int)a - (int)b;
+}
+
+
+/**
+ * @brief shell建立变量索引
+ * 
+ * @param shell shell对象
+ * 
+ * @note 索引被其他shell使用时不会重建，此时当前shell使用顺序查找
+ */
+static void shellVariableIndexBuild(SHELL_TypeDef *shell)
+{
+    SHELL_VaribaleTypeDef *base = shell->variableBase;
+    unsigned short number = shell->variableNumber;
+    unsigned short gap;
+    unsigned short tmp;
+    unsigned short j;
+
+    if (shellVariableIndex.base == base && shellVariableIndex.number == number)
     {
         return;
     }
-#endif
-
-    if (shell->length != 0)
+    if (shellVariableIndex.base != NULL)
     {
-        shell->buffer[shell->length] = 0;
-        for (short i = 0; i < shell->commandNumber; i++)
+        for (short i = 0; i < SHELL_MAX_NUMBER; i++)
         {
-            if (shellStringCompare(shell->buffer, 
-                (char *)(base + i)->name)
-                == shell->length)
+            if (shellList[i] != NULL && shellList[i] != shell
+                && shellList[i]->variableBase == shellVariableIndex.base
+                && shellList[i]->variableNumber == shellVariableIndex.number)
             {
-                if (matchNum != 0)
-                {
-                    if (matchNum == 1)
-                    {
-                        shellDisplay(shell, "\r\n");
-                    }
-                    shellDisplayItem(shell, lastMatchIndex);
-                    length = shellStringCompare((char *)(base + lastMatchIndex)->name,
-                                                (char *)(base +i)->name);
-                    maxMatch = (maxMatch > length) ? length : maxMatch;
-                }
-                lastMatchIndex = i;
-                matchNum ++;
+                return;
             }
         }
-
-        if (matchNum == 0)
-        {
-            return;
-        }
-        if (matchNum == 1)
-        {
-            shellClearLine(shell);
-        }
-        if (matchNum != 0)
-        {
-            shell->length = shellStringCopy(shell->buffer,
-                                            (char *)(base + lastMatchIndex)->name);
-        }
-        if (matchNum > 1)
-        {
-            shellDisplayItem(shell, lastMatchIndex);
-            shellDisplay(shell, shell->command);
-            shell->length = maxMatch;
-        }
-        shell->buffer[shell->length] = 0;
-        shell->cursor = shell->length;
-        shellDisplay(shell, shell->buffer);
     }
-    else
+    shellVariableIndex.base = NULL;
+    if (base == NULL || number > SHELL_VARIABLE_INDEX_MAX)
     {
-        shell->isActive = 1;
-        shellHelp(1, (void *)0);
-        shell->isActive = 0;
-        shellDisplay(shell, shell->command);
+        return;
     }
 
-#if SHELL_LONG_HELP == 1
-    if (SHELL_GET_TICK())
+    for (unsigned short i = 0; i < number; i++)
     {
-        if (matchNum == 1
-            && shell->status.tabFlag == 1
-            && SHELL_GET_TICK() - shell->activeTime < SHELL_DOUBLE_CLICK_TIME)
+        shellVariableIndex.index[i] = i;
+    }
+    for (gap = number / 2; gap > 0; gap /= 2)
+    {
+        for (unsigned short i = gap; i < number; i++)
         {
-            shellClearLine(shell);
-            for (short i = shell->length; i >= 0; i--)
+            tmp = shellVariableIndex.index[i];
+            for (j = i; j >= gap
+                 && shellVariableIndexCompare(base, shellVariableIndex.index[j - gap], tmp) > 0;
+                 j -= gap)
             {
-                shell->buffer[i + 5] = shell->buffer[i];
+                shellVariableIndex.index[j] = shellVariableIndex.index[j - gap];
             }
-            shellStringCopy(shell->buffer, "help");
-            shell->buffer[4] = ' ';
-            shell->length += 5;
-            shell->cursor = shell->length;
-            shellDisplay(shell, shell->buffer);
+            shellVariableIndex.index[j] = tmp;
         }
     }
-#endif /** SHELL_LONG_HELP == 1 */
+    shellVariableIndex.base = base;
+    shellVariableIndex.number = number;
 }
+#endif /** SHELL_VARIABLE_INDEX_MAX > 0 */
 
 
 /**
- * @brief shell正常按键处理
+ * @brief shell变量名比较
+ * 
+ * @param varName 变量表中的变量名
+ * @param name 待比较的变量名，不要求以'\0'结束
+ * @param length 待比较的变量名长度
+ * @return int 比较结果，与strcmp相同
+ */
+static int shellVariableCompare(const char *varName, const char *name, unsigned short length)
+{
+    int result = strncmp(varName, name, length);
+    return (result != 0) ? result : (varName[length] != 0);
+}
+
+
+/**
+ * @brief shell查找变量
  * 
  * @param shell shell对象
- * @param data 输入的数据
+ * @param var 变量名，可以以`$`开头，数组变量可以使用`name[index]`指定元素
+ * @param element 数组元素下标，未指定元素时为-1
+ * @return SHELL_VaribaleTypeDef* 查找到的变量，未找到、下标为空或越界返回NULL
  */
-static void shellNormal(SHELL_TypeDef *shell, char data)
+static SHELL_VaribaleTypeDef *shellSeekVariable(SHELL_TypeDef *shell, const char *var, int *element)
 {
-    if (data == 0)
+    SHELL_VaribaleTypeDef *base = shell->variableBase;
+    SHELL_VaribaleTypeDef *variable = NULL;
+    unsigned short length = 0;
+
+    if (var[0] == '$')
     {
-        return;
+        var++;
     }
-    if (shell->length < SHELL_COMMAND_MAX_LENGTH - 1)
+    while (var[length] && var[length] != '[')
     {
-        if (shell->length == shell->cursor)
+        length++;
+    }
+    *element = -1;
+    if (var[length] == '[')
+    {
+        const char *p = var + length + 1;
+
+        if (*p == ']')
         {
-            shell->buffer[shell->length++] = data;
-            shell->cursor++;
-            shellDisplayByte(shell, data);
+            return NULL;
         }
-        else
+        *element = 0;
+        for (; *p != ']'; p++)
         {
-            for (short i = shell->length - shell->cursor; i > 0; i--)
+            if (*p < '0' || *p > '9')
             {
-                shell->buffer[shell->cursor + i] = shell->buffer[shell->cursor + i - 1];
+                return NULL;
             }
-            shell->buffer[shell->cursor++] = data;
-            shell->buffer[++shell->length] = 0;
-            for (short i = shell->cursor - 1; i < shell->length; i++)
+            *element = *element * 10 + *p - '0';
+        }
+        if (*(p + 1) != 0)
+        {
+            return NULL;
+        }
+    }
+
+#if SHELL_VARIABLE_INDEX_MAX > 0
+    if (shellVariableIndex.base == base && shellVariableIndex.number == shell->variableNumber)
+    {
+        unsigned short low = 0;
+        unsigned short high = shell->variableNumber;
+        unsigned short mid;
+
+        while (low < high)
+        {
+            mid = low + (high - low) / 2;
+            if (shellVariableCompare((base + shellVariableIndex.index[mid])->name, var, length) < 0)
             {
-                shellDisplayByte(shell, shell->buffer[i]);
+                low = mid + 1;
             }
-            for (short i = shell->length - shell->cursor; i > 0; i--)
+            else
             {
-                shellDisplayByte(shell, '\b');
+                high = mid;
             }
         }
+        if (low < shell->variableNumber
+            && shellVariableCompare((base + shellVariableIndex.index[low])->name, var, length) == 0)
+        {
+            variable = base + shellVariableIndex.index[low];
+        }
     }
     else
+#endif /** SHELL_VARIABLE_INDEX_MAX > 0 */
     {
-        shellDisplay(shell, shellText[TEXT_CMD_TOO_LONG]);
-        shellDisplay(shell, shell->command);
-        shellDisplay(shell, shell->buffer);
-        shell->cursor = shell->length;
+        for (unsigned short i = 0; i < shell->variableNumber; i++)
+        {
+            if (shellVariableCompare((base + i)->name, var, length) == 0)
+            {
+                variable = base + i;
+                break;
+            }
+        }
+    }
+
+    if (variable && *element >= 0)
+    {
+    #if SHELL_VAR_EXTENDED == 1
+        if (!(variable->type & SHELL_VAR_ARRAY) || *element >= (variable->type >> 8))
+        {
+            return NULL;
+        }
+    #else
+        return NULL;
+    #endif /** SHELL_VAR_EXTENDED == 1 */
     }
+    return variable;
 }
 
 
+#if SHELL_VAR_EXTENDED == 1
 /**
- * @brief shell开始ansi控制序列
+ * @brief shell获取变量元素大小
+ * 
+ * @param type 元素类型
+ * @return unsigned short 元素大小
+ */
+static unsigned short shellVariableSize(int type)
+{
+    switch (type)
+    {
+    case SHELL_VAR_SHORT:
+        return sizeof(short);
+    case SHELL_VAR_CHAR:
+        return sizeof(char);
+    case SHELL_VAR_FLOAT:
+        return sizeof(float);
+    case SHELL_VAR_INT64:
+        return sizeof(long long);
+    default:
+        return sizeof(int);
+    }
+}
+#endif /** SHELL_VAR_EXTENDED == 1 */
+
+
+/**
+ * @brief shell获取变量值的地址和类型
+ * 
+ * @param variable 变量
+ * @param element 数组元素下标，-1表示变量本身
+ * @param type 值的类型，数组元素为元素类型
+ * @return void* 值的地址
+ */
+static void *shellVariableAddress(SHELL_VaribaleTypeDef *variable, int element, int *type)
+{
+    *type = variable->type;
+#if SHELL_VAR_EXTENDED == 1
+    if ((*type & SHELL_VAR_ARRAY) && element >= 0)
+    {
+        *type &= 0x7F;
+        return (char *)variable->value + element * shellVariableSize(*type);
+    }
+#else
+    (void)element;
+#endif /** SHELL_VAR_EXTENDED == 1 */
+    return (void *)variable->value;
+}
+
+
+/**
+ * @brief shell获取变量值
+ * 
+ * @param variable 变量
+ * @param element 数组元素下标，-1表示变量本身
+ * @return int 变量值
+ */
+static int shellVariableValue(SHELL_VaribaleTypeDef *variable, int element)
+{
+    void *address;
+    int type;
+
+    address = shellVariableAddress(variable, element, &type);
+    switch (type)
+    {
+    case SHELL_VAR_INT:
+        return *((int *)address);
+    case SHELL_VAR_SHORT:
+        return *((short *)address);
+    case SHELL_VAR_CHAR:
+        return *((char *)address);
+#if SHELL_VAR_EXTENDED == 1
+    case SHELL_VAR_FLOAT:
+        return (int)*((float *)address);
+    case SHELL_VAR_INT64:
+        return (int)*((long long *)address);
+#endif /** SHELL_VAR_EXTENDED == 1 */
+    default:
+        return (int)(size_t)address;
+    }
+}
+
+
+/**
+ * @brief shell获取变量
  * 
  * @param shell shell对象
+ * @param var 参数
+ * @return int 变量值
+ * 
+ * @note 浮点变量返回转换后的整数，需要浮点值时使用`shellGetVariableFloat`，
+ *       64位整型变量返回低32位，数组变量未指定元素时返回数组地址
  */
-static void shellAnsiStart(SHELL_TypeDef *shell)
+int shellGetVariable(SHELL_TypeDef *shell, char *var)
 {
-    shell->status.inputMode = SHELL_ANSI_ESC;
+    SHELL_VaribaleTypeDef *variable;
+    int element;
+
+    variable = shellSeekVariable(shell, var, &element);
+    return variable ? shellVariableValue(variable, element) : 0;
 }
 
 
 /**
- * @brief shell ansi控制序列处理
+ * @brief shell获取变量浮点值
  * 
  * @param shell shell对象
- * @param data 输入的数据
+ * @param var 参数
+ * @return float 变量值，整型变量转换为浮点数
  */
-void shellAnsi(SHELL_TypeDef *shell, char data)
+float shellGetVariableFloat(SHELL_TypeDef *shell, char *var)
 {
-    switch ((unsigned char)(shell->status.inputMode))
+#if SHELL_VAR_EXTENDED == 1
+    SHELL_VaribaleTypeDef *variable;
+    void *address;
+    int element;
+    int type;
+
+    variable = shellSeekVariable(shell, var, &element);
+    if (variable)
     {
-    case SHELL_ANSI_CSI:
-        switch (data)
+        address = shellVariableAddress(variable, element, &type);
+        if (type == SHELL_VAR_FLOAT)
         {
-        case 0x41:                                              /** 方向上键 */
-            shellHistory(shell, 0);
-            break;  
-        
-        case 0x42:                                              /** 方向下键 */
-            shellHistory(shell, 1);
-            break;
+            return *((float *)address);
+        }
+        if (type == SHELL_VAR_INT64)
+        {
+            return (float)*((long long *)address);
+        }
+    }
+#endif /** SHELL_VAR_EXTENDED == 1 */
+    return (float)shellGetVariable(shell, var);
+}
 
-        case 0x43:                                              /** 方向右键 */
-            if (shell->cursor < shell->length)
-            {
-                shellDisplayByte(shell, shell->buffer[shell->cursor]);
-                shell->cursor++;
-            }
-            break;
 
-        case 0x44:                                              /** 方向左键 */
-            if (shell->cursor > 0)
+/**
+ * @brief shell设置变量值
+ * 
+ * @param var 变量
+ * @param value 值
+ * 
+ * @note 通过命令行调用时，浮点变量按值参数的原文解析出浮点值，缺少值参数时不修改，
+ *       其他方式调用时`value`按整数转换为浮点值，64位整型变量的值按32位有符号数扩展
+ */
+void shellSetVariable(char *var, int value)
+{
+    SHELL_TypeDef *shell = shellGetCurrent();
+    SHELL_VaribaleTypeDef *variable;
+    void *address;
+    int element;
+    int type;
+
+    if (!shell)
+    {
+        return;
+    }
+    variable = shellSeekVariable(shell, var, &element);
+    if (!variable)
+    {
+        shellDisplay(shell, "var not found\r\n");
+        return;
+    }
+    address = shellVariableAddress(variable, element, &type);
+    switch (type)
+    {
+    case SHELL_VAR_INT:
+        *((int *)address) = value;
+        break;
+    case SHELL_VAR_SHORT:
+        *((short *)address) = value;
+        break;
+    case SHELL_VAR_CHAR:
+        *((char *)address) = value;
+        break;
+#if SHELL_VAR_EXTENDED == 1
+    case SHELL_VAR_FLOAT:
+    #if SHELL_AUTO_PRASE == 1
+        if (var == shell->param[1])
+        {
+            if (!shell->param[2]
+                || shellExtParseFloat(shell, shell->param[2], shell->paramType[2],
+                                      (float *)address) != 0)
             {
-                shellDisplayByte(shell, '\b');
-                shell->cursor--;
+                shellDisplay(shell, "invalid value\r\n");
+                return;
             }
             break;
+        }
+    #endif /** SHELL_AUTO_PRASE == 1 */
+        *((float *)address) = (float)value;
+        break;
+    case SHELL_VAR_INT64:
+        *((long long *)address) = value;
+        break;
+#endif /** SHELL_VAR_EXTENDED == 1 */
+    case SHELL_VAL:
+        shellDisplay(shell, "can't set val\r\n");
+        break;
+    default:
+        break;
+    }
+    shellDisplayVariable(shell, var);
+}
+SHELL_EXPORT_CMD_EX(setVar, shellSetVariable, set var, setVar $[var] [value]);
 
-        default:
-            break;
+
+#if SHELL_VAR_EXTENDED == 1
+/**
+ * @brief shell显示64位整数
+ * 
+ * @param shell shell对象
+ * @param value 值
+ * @param hex 是否同时显示十六进制
+ */
+static void shellDisplayInt64(SHELL_TypeDef *shell, long long value, unsigned char hex)
+{
+    char str[21];
+    unsigned long long v = value;
+    signed char i = 20;
+
+    str[20] = 0;
+    if (value < 0)
+    {
+        shellDisplay(shell, "-");
+        v = -v;
+    }
+    do
+    {
+        str[--i] = v % 10 + '0';
+        v /= 10;
+    } while (v);
+    shellDisplay(shell, str + i);
+    if (hex)
+    {
+        v = value;
+        str[16] = 0;
+        for (i = 15; i >= 0; i--)
+        {
+            str[(int)i] = "0123456789abcdef"[v & 0x0F];
+            v >>= 4;
         }
-        shell->status.inputMode = SHELL_IN_NORMAL;
+        shellDisplay(shell, ", 0x");
+        shellDisplay(shell, str);
+    }
+}
+
+
+/**
+ * @brief shell显示浮点数
+ * 
+ * @param shell shell对象
+ * @param value 值
+ * 
+ * @note 保留6位小数，绝对值不小于1e9时使用科学计数法
+ */
+static void shellDisplayFloat(SHELL_TypeDef *shell, float value)
+{
+    char str[8] = "000000";
+    unsigned int integer;
+    unsigned int fraction;
+    int exponent = 0;
+
+    if (value != value)
+    {
+        shellDisplay(shell, "nan");
+        return;
+    }
+    if (value < 0)
+    {
+        shellDisplay(shell, "-");
+        value = -value;
+    }
+    if (value > 3.402823466e38f)
+    {
+        shellDisplay(shell, "inf");
+        return;
+    }
+    while (value >= 1e9f)
+    {
+        value /= 10;
+        exponent++;
+    }
+    if (exponent > 0)
+    {
+        while (value >= 10)
+        {
+            value /= 10;
+            exponent++;
+        }
+    }
+    integer = (unsigned int)value;
+    fraction = (unsigned int)((value - integer) * 1e6f + 0.5f);
+    if (fraction >= 1000000)
+    {
+        integer++;
+        fraction -= 1000000;
+    }
+    shellDisplayInt64(shell, integer, 0);
+    for (signed char i = 5; i >= 0; i--)
+    {
+        str[(int)i] = fraction % 10 + '0';
+        fraction /= 10;
+    }
+    shellDisplay(shell, ".");
+    shellDisplay(shell, str);
+    if (exponent > 0)
+    {
+        shellDisplay(shell, "e+");
+        shellDisplayInt64(shell, exponent, 0);
+    }
+}
+
+
+/**
+ * @brief shell显示变量元素值
+ * 
+ * @param shell shell对象
+ * @param address 值地址
+ * @param type 值类型
+ */
+static void shellDisplayElement(SHELL_TypeDef *shell, void *address, int type)
+{
+    switch (type)
+    {
+    case SHELL_VAR_SHORT:
+        shellDisplayInt64(shell, *((short *)address), 0);
         break;
-
-    case SHELL_ANSI_ESC:
-        if (data == 0x5B)
-        {
-            shell->status.inputMode = SHELL_ANSI_CSI;
-        }
-        else
-        {
-            shell->status.inputMode = SHELL_IN_NORMAL;
-        }
+    case SHELL_VAR_CHAR:
+        shellDisplayInt64(shell, *((char *)address), 0);
+        break;
+    case SHELL_VAR_FLOAT:
+        shellDisplayFloat(shell, *((float *)address));
+        break;
+    case SHELL_VAR_INT64:
+        shellDisplayInt64(shell, *((long long *)address), 0);
         break;
-
     default:
+        shellDisplayInt64(shell, *((int *)address), 0);
         break;
     }
 }
+#endif /** SHELL_VAR_EXTENDED == 1 */
 
 
 /**
- * @brief shell处理
+ * @brief shell显示变量值
  * 
  * @param shell shell对象
- * @param data 输入数据
+ * @param variable 变量
+ * @param element 数组元素下标，-1表示变量本身
  */
-void shellHandler(SHELL_TypeDef *shell, char data)
+static void shellDisplayVariableValue(SHELL_TypeDef *shell,
+                                      SHELL_VaribaleTypeDef *variable, int element)
 {
-#if SHELL_USING_AUTH == 1 && SHELL_LOCK_TIMEOUT > 0
-    if (SHELL_GET_TICK())
-    {
-        if (SHELL_GET_TICK() - shell->activeTime > SHELL_LOCK_TIMEOUT)
-        {
-            shell->status.authFlag = 0;
-        }
-    }
-#endif
-    if (shell->status.inputMode == SHELL_IN_NORMAL)
-    {
-        char keyDefFind = 0;
-        SHELL_KeyFunctionDef *base = (SHELL_KeyFunctionDef *)shell->keyFuncBase;
+#if SHELL_VAR_EXTENDED == 1
+    void *address;
+    int type;
 
-    #if SHELL_USING_AUTH == 1
-        if (shell->status.authFlag == 1)
-        {
-    #endif
-            for (short i = 0; i < shell->keyFuncNumber; i++)
-            {
-                if (base[i].keyCode == data) {
-                    if (base[i].keyFunction) {
-                        base[i].keyFunction(shell);
-                    }
-                    keyDefFind = 1;
-                }
-            }
-    #if SHELL_USING_AUTH == 1
-        }
-    #endif
-        if (keyDefFind == 0)
+    address = shellVariableAddress(variable, element, &type);
+    if (type & SHELL_VAR_ARRAY)
+    {
+        type &= 0x7F;
+        shellDisplay(shell, "[");
+        for (int i = 0; i < (variable->type >> 8); i++)
         {
-            for (short i = 0; 
-                i < sizeof(shellDefaultKeyFunctionList) / sizeof(SHELL_KeyFunctionDef);
-                i++)
+            if (i > 0)
             {
-                if (shellDefaultKeyFunctionList[i].keyCode == data) {
-                    if (shellDefaultKeyFunctionList[i].keyFunction) {
-                        shellDefaultKeyFunctionList[i].keyFunction(shell);
-                    }
-                    keyDefFind = 1;
-                }
+                shellDisplay(shell, ", ");
             }
+            shellDisplayElement(shell, (char *)address + i * shellVariableSize(type), type);
         }
-        if (keyDefFind == 0)
-        {
-            shellNormal(shell, data);
-        }
+        shellDisplay(shell, "]\r\n");
+        return;
     }
-    else
+    if (type == SHELL_VAR_FLOAT)
     {
-        shellAnsi(shell, data);
+        shellDisplayFloat(shell, *((float *)address));
+        shellDisplay(shell, "\r\n");
+        return;
     }
-#if SHELL_LONG_HELP == 1 || (SHELL_USING_AUTH && SHELL_LOCK_TIMEOUT > 0)
-    if (SHELL_GET_TICK())
+    if (type == SHELL_VAR_INT64)
     {
-        shell->activeTime = SHELL_GET_TICK();
+        shellDisplayInt64(shell, *((long long *)address), 1);
+        shellDisplay(shell, "\r\n");
+        return;
     }
-#endif
-#if SHELL_LONG_HELP == 1
-    shell->status.tabFlag = data == '\t' ? 1 : 0;
-#endif
+#endif /** SHELL_VAR_EXTENDED == 1 */
+    shellDisplayValue(shell, shellVariableValue(variable, element));
 }
 
 
-#if SHELL_USING_TASK == 1
 /**
- * @brief shell 任务
- * 
- * @param param shell对象
+ * @brief shell显示变量
  * 
- * @note 使用操作系统时，定义的shell read函数必须是阻塞式的
- * @note 不使用操作系统时，可以通过不断查询的方式使用shell，修改宏SHELL_TASK_WHILE
- *       为0，然后在主循环中不断调用此函数
+ * @param shell shell对象
+ * @param var 变量
  */
-void shellTask(void *param)
+static void shellDisplayVariable(SHELL_TypeDef *shell, char *var)
 {
-    SHELL_TypeDef *shell = (SHELL_TypeDef *)param;
-    char data;
-    if (shell->read == NULL)
+    SHELL_VaribaleTypeDef *variable;
+    int element;
+
+    shellDisplay(shell, var[0] == '$' ? var + 1 : var);
+    shellDisplay(shell, " = ");
+    variable = shellSeekVariable(shell, var, &element);
+    if (variable)
     {
-        shellDisplay(shell, shellText[TEXT_READ_NOT_DEF]);
-        while (1) ;
+        shellDisplayVariableValue(shell, variable, element);
     }
-#if SHELL_TASK_WHILE == 1
-    while (1)
+    else
     {
-#endif
-        if (shell->read(&data) == 0)
-        {
-            shellInput(shell, data);
-        }
-#if SHELL_TASK_WHILE == 1
+        shellDisplayValue(shell, 0);
     }
-#endif
 }
-#endif
 
 
-#if SHELL_USING_VAR == 1
+#if SHELL_WATCH_NUMBER > 0
 /**
- * @brief shell获取变量
+ * @brief shell添加监视变量
  * 
- * @param shell shell对象
- * @param var 参数
- * @return int 变量值
+ * @param var 变量名，数组变量可以使用`name[index]`指定元素
+ * @return int 监视的变量数量，失败返回-1
  */
-int shellGetVariable(SHELL_TypeDef *shell, char *var)
+int shellWatch(char *var)
 {
-    SHELL_VaribaleTypeDef *base = shell->variableBase;
-    int value = 0;
+    SHELL_TypeDef *shell = shellGetCurrent();
+    SHELL_VaribaleTypeDef *variable;
+    int element;
 
-    if (var[0] == '$')
+    if (!shell)
     {
-        var++;
+        return -1;
+    }
+    variable = shellSeekVariable(shell, var, &element);
+    if (!variable)
+    {
+        shellDisplay(shell, "var not found\r\n");
+        return -1;
     }
+    if (shell->watch.number >= SHELL_WATCH_NUMBER)
+    {
+        shellDisplay(shell, "watch list full\r\n");
+        return -1;
+    }
+    shell->watch.variable[shell->watch.number] = variable;
+    shell->watch.element[shell->watch.number] = element;
+    return ++shell->watch.number;
+}
+SHELL_EXPORT_CMD_EX(watch, shellWatch, watch var, watch [var] --add var to watch list);
+
+
+/**
+ * @brief shell开始输出监视变量
+ * 
+ * @param period 输出周期，单位为`SHELL_GET_TICK()`单位，为0时每次调用`shellWatchTick()`都输出
+ * @param binary 是否使用二进制输出，仅在机器模式下有效
+ */
+void shellWatchStart(int period, int binary)
+{
+    SHELL_TypeDef *shell = shellGetCurrent();
 
-    for (short i = 0; i < shell->variableNumber; i++)
+    if (!shell)
     {
-        if (strcmp((const char *)var, (const char *)(base + i)->name) == 0)
-        {
-            switch ((base + i)->type)
-            {
-            case SHELL_VAR_INT:
-                value = *((int *)((base + i)->value));
-                break;
-            case SHELL_VAR_SHORT:
-                value = *((short *)((base + i)->value));
-                break;
-            case SHELL_VAR_CHAR:
-                value = *((char *)((base + i)->value));
-                break;
-            case SHELL_VAR_POINTER:
-            case SHELL_VAL:
-                value = (int)((base + i)->value);
-            default:
-                break;
-            }
-        }
+        return;
     }
-    return value;
+    shell->watch.period = period;
+    shell->watch.last = SHELL_GET_TICK();
+    shell->watch.binary = binary ? 1 : 0;
+    shell->watch.active = 1;
 }
+SHELL_EXPORT_CMD_EX(watchStart, shellWatchStart, start watch, watchStart [period] [binary] --stream watched vars);
 
 
 /**
- * @brief shell设置变量值
+ * @brief shell停止输出监视变量并清空监视列表
  * 
- * @param var 变量
- * @param value 值
  */
-void shellSetVariable(char *var, int value)
+void shellWatchStop(void)
 {
     SHELL_TypeDef *shell = shellGetCurrent();
-    char isVarFind = 0;
+
     if (!shell)
     {
         return;
     }
-    SHELL_VaribaleTypeDef *base = shell->variableBase;
+    shell->watch.active = 0;
+    shell->watch.number = 0;
+}
+SHELL_EXPORT_CMD(watchStop, shellWatchStop, stop watch);
+
+
+#if SHELL_USING_MACHINE == 1
+/**
+ * @brief shell以二进制帧输出监视变量
+ * 
+ * @param shell shell对象
+ * 
+ * @note 帧类型为`SHELL_MACHINE_WATCH`，序号为0，数据为各变量值按监视顺序依次排列的
+ *       小端序二进制，长度与变量类型一致，指针，常量和未指定元素的数组输出4字节地址
+ */
+static void shellWatchFrame(SHELL_TypeDef *shell)
+{
+    char data[SHELL_MACHINE_DATA_SIZE];
+    unsigned char length = 0;
+    unsigned char size;
+    unsigned char seq;
+    unsigned long long value;
+    void *address;
+    int type;
 
-    for (short i = 0; i < shell->variableNumber; i++)
+    for (unsigned char i = 0; i < shell->watch.number; i++)
     {
-        if (strcmp((const char *)var, (const char *)(base + i)->name) == 0)
+        address = shellVariableAddress(shell->watch.variable[i], shell->watch.element[i], &type);
+        switch (type)
         {
-            switch ((base + i)->type)
-            {
-            case SHELL_VAR_INT:
-                *((int *)((base + i)->value)) = value;
-                break;
-            case SHELL_VAR_SHORT:
-                *((short *)((base + i)->value)) = value;
-                break;
-            case SHELL_VAR_CHAR:
-                *((char *)((base + i)->value)) = value;
-                break;
-            case SHELL_VAL:
-                shellDisplay(shell, "can't set val\r\n");
-                break;
-            default:
-                break;
-            }
-            isVarFind = 1;
+        case SHELL_VAR_SHORT:
+            value = *((unsigned short *)address);
+            size = 2;
+            break;
+        case SHELL_VAR_CHAR:
+            value = *((unsigned char *)address);
+            size = 1;
+            break;
+    #if SHELL_VAR_EXTENDED == 1
+        case SHELL_VAR_INT64:
+            value = *((unsigned long long *)address);
+            size = 8;
+            break;
+        case SHELL_VAR_FLOAT:
+    #endif /** SHELL_VAR_EXTENDED == 1 */
+        case SHELL_VAR_INT:
+            value = *((unsigned int *)address);
+            size = 4;
+            break;
+        default:
+            value = (unsigned int)(size_t)address;
+            size = 4;
+            break;
+        }
+        if (length + size > sizeof(data))
+        {
+            break;
+        }
+        while (size--)
+        {
+            data[length++] = (char)value;
+            value >>= 8;
         }
     }
-    if (!isVarFind)
-    {
-        shellDisplay(shell, "var not found\r\n");
-    }
-    else 
-    {
-        shellDisplayVariable(shell, var);
-    }
+    seq = shell->machine.seq;
+    shell->machine.seq = 0;
+    shellMachineFrame(shell, SHELL_MACHINE_WATCH, data, length);
+    shell->machine.seq = seq;
 }
-SHELL_EXPORT_CMD_EX(setVar, shellSetVariable, set var, setVar $[var] [value]);
+#endif /** SHELL_USING_MACHINE == 1 */
 
 
 /**
- * @brief shell显示变量
+ * @brief shell监视变量输出处理
  * 
  * @param shell shell对象
- * @param var 变量
+ * 
+ * @note 在处理该shell输入的任务或主循环中周期性调用，到达`watchStart`设置的周期时输出所有
+ *       监视变量，不需要上位机发送命令
+ * @note 输出与命令输出共用发送缓冲，管道和重定向状态，不能在定时器回调或中断中调用，
+ *       异步命令正在执行，管道或重定向有效时跳过，在之后的调用中输出
  */
-static void shellDisplayVariable(SHELL_TypeDef *shell, char *var)
+void shellWatchTick(SHELL_TypeDef *shell)
 {
-    shellDisplay(shell, var[0] == '$' ? var + 1 : var);
-    shellDisplay(shell, " = ");
-    shellDisplayValue(shell, shellGetVariable(shell, var));
+    unsigned int tick = SHELL_GET_TICK();
+
+    if (!shell->watch.active || shell->watch.number == 0
+        || tick - shell->watch.last < shell->watch.period)
+    {
+        return;
+    }
+#if SHELL_USING_ASYNC == 1
+    if (shell->async.busy)
+    {
+        return;
+    }
+#endif /** SHELL_USING_ASYNC == 1 */
+#if SHELL_USING_PIPE == 1
+    if (shell->pipe.number != 0)
+    {
+        return;
+    }
+#endif /** SHELL_USING_PIPE == 1 */
+#if SHELL_USING_REDIRECT == 1
+    if (shell->sink)
+    {
+        return;
+    }
+#endif /** SHELL_USING_REDIRECT == 1 */
+    shell->watch.last = tick;
+#if SHELL_USING_MACHINE == 1
+    if (shell->status.machineMode && shell->watch.binary)
+    {
+        shellWatchFrame(shell);
+        return;
+    }
+#endif /** SHELL_USING_MACHINE == 1 */
+    for (unsigned char i = 0; i < shell->watch.number; i++)
+    {
+        shellDisplay(shell, shell->watch.variable[i]->name);
+    #if SHELL_VAR_EXTENDED == 1
+        if (shell->watch.element[i] >= 0)
+        {
+            shellDisplay(shell, "[");
+            shellDisplayInt64(shell, shell->watch.element[i], 0);
+            shellDisplay(shell, "]");
+        }
+    #endif /** SHELL_VAR_EXTENDED == 1 */
+        shellDisplay(shell, " = ");
+        shellDisplayVariableValue(shell, shell->watch.variable[i], shell->watch.element[i]);
+    }
 }
+#endif /** SHELL_WATCH_NUMBER > 0 */
 
 
 /**
@@ -1199,13 +5302,11 @@ void shellListVariables(void)
 
     shellDisplay(shell, shellText[TEXT_VAR_LIST]);   
 
-    for (short i = 0; i <  shell->variableNumber; i++)
+    for (unsigned short i = 0; i < shell->variableNumber; i++)
     {
-        spaceLength = 22 - shellDisplay(shell, (base + i)->name);
-        spaceLength = (spaceLength > 0) ? spaceLength : 4;
-        do {
-            shellDisplay(shell, " ");
-        } while (--spaceLength);
+        spaceLength = shellDisplay(shell, (base + i)->name);
+        spaceLength = (spaceLength < 22) ? 22 - spaceLength : 4;
+        shellDisplayRepeat(shell, ' ', spaceLength);
         shellDisplay(shell, "--");
         shellDisplay(shell, (base + i)->desc);
         shellDisplay(shell, "\r\n");
@@ -1218,20 +5319,17 @@ SHELL_EXPORT_CMD(vars, shellListVariables, show vars);
  * @brief shell显示一条命令信息
  * 
  * @param shell shell对象
- * @param index 要显示的命令索引
+ * @param command 要显示的命令
  */
-static void shellDisplayItem(SHELL_TypeDef *shell, unsigned short index)
+static void shellDisplayItem(SHELL_TypeDef *shell, SHELL_CommandTypeDef *command)
 {
     unsigned short spaceLength;
-    SHELL_CommandTypeDef *base = shell->commandBase;
     
-    spaceLength = 22 - shellDisplay(shell, (base + index)->name);
-    spaceLength = (spaceLength > 0) ? spaceLength : 4;
-    do {
-        shellDisplay(shell, " ");
-    } while (--spaceLength);
+    spaceLength = shellDisplay(shell, command->name);
+    spaceLength = (spaceLength < 22) ? 22 - spaceLength : 4;
+    shellDisplayRepeat(shell, ' ', spaceLength);
     shellDisplay(shell, "--");
-    shellDisplay(shell, (base + index)->desc);
+    shellDisplay(shell, command->desc);
     shellDisplay(shell, "\r\n");
 
 }
@@ -1250,6 +5348,25 @@ void shellHelp(int argc, char *argv[])
     {
         return;
     }
+    shellShowHelp(shell, argc, argv);
+}
+SHELL_EXPORT_CMD_EX(help, shellHelp, command help, help [command] --show help info of command);
+
+
+/**
+ * @brief shell显示帮助
+ * 
+ * @param shell shell对象
+ * @param argc 参数个数
+ * @param argv 参数
+ */
+static void shellShowHelp(SHELL_TypeDef *shell, int argc, char *argv[])
+{
+#if SHELL_USING_REGISTRY == 1
+    SHELL_LIST_LOCK();
+    shellRegistrySync(shell);
+    SHELL_LIST_UNLOCK();
+#endif /** SHELL_USING_REGISTRY == 1 */
 #if SHELL_LONG_HELP == 1
     if (argc == 1)
     {
@@ -1257,35 +5374,122 @@ void shellHelp(int argc, char *argv[])
         shellDisplay(shell, shellText[TEXT_FUN_LIST]);       
         for(unsigned short i = 0; i < shell->commandNumber; i++)
         {
-            shellDisplayItem(shell, i);
+            shellDisplayItem(shell, shellCommandAt(shell->commandBase, i));
         }
 #if SHELL_LONG_HELP == 1
     }
     else if (argc == 2) {
-        SHELL_CommandTypeDef *base = shell->commandBase;
-        for (unsigned char i = 0; i < shell->commandNumber; i++)
+        SHELL_CommandTypeDef *command = shellSeekCommand(shell, (const char *)argv[1]);
+        if (command)
         {
-            if (strcmp((const char *)argv[1], (base + i)->name) == 0)
+            shellDisplay(shell, "command help --");
+            shellDisplay(shell, command->name);
+            shellDisplay(shell, ":\r\n");
+            shellDisplay(shell, command->desc);
+            shellDisplay(shell, "\r\n");
+            if (command->help)
             {
-                
-                shellDisplay(shell, "command help --");
-                shellDisplay(shell, (base + i)->name);
-                shellDisplay(shell, ":\r\n");
-                shellDisplay(shell, (base + i)->desc);
+                shellDisplay(shell, command->help);
                 shellDisplay(shell, "\r\n");
-                if ((base + i)->help)
-                {
-                    shellDisplay(shell, (base + i)->help);
-                    shellDisplay(shell, "\r\n");
-                }
-                return;
             }
+            return;
         }
         shellDisplay(shell, shellText[TEXT_CMD_NONE]);
     }
 #endif /** SHELL_LONG_HELP == 1 */
 }
-SHELL_EXPORT_CMD_EX(help, shellHelp, command help, help [command] --show help info of command);
+
+
+#if SHELL_AUTO_PRASE == 1
+/**
+ * @brief 执行存储在指定地址的脚本
+ * 
+ * @param address 脚本地址，以指针宽度的整型传递
+ * @param length 脚本长度，为0时执行到'\0'为止
+ * @return int 脚本执行结果
+ */
+int shellSource(size_t address, unsigned int length)
+{
+    SHELL_TypeDef *shell = shellGetCurrent();
+    if (!shell || !address)
+    {
+        return -1;
+    }
+    return shellExecScript(shell, (const char *)address, length ? length : 0xFFFFFFFF);
+}
+SHELL_EXPORT_CMD_EX(source, shellSource, run script, source [address] [length] --run script stored at address);
+#endif /** SHELL_AUTO_PRASE == 1 */
+
+
+#if SHELL_USING_STATS == 1
+/**
+ * @brief shell按列显示无符号数
+ * 
+ * @param shell shell对象
+ * @param value 值
+ * @param width 列宽，数值长度不足时补空格，为0时不补空格
+ */
+static void shellDisplayColumn(SHELL_TypeDef *shell, unsigned int value, unsigned short width)
+{
+    char str[11];
+    unsigned char i = 10;
+
+    str[10] = 0;
+    do
+    {
+        str[--i] = value % 10 + '0';
+        value /= 10;
+    } while (value);
+    shellDisplay(shell, str + i);
+    if (width > 0)
+    {
+        shellDisplayRepeat(shell, ' ', (width > 10 - i) ? width - (10 - i) : 1);
+    }
+}
+
+
+/**
+ * @brief shell显示命令统计
+ * 
+ * @note 只显示执行过的命令，按第一次执行的顺序排列，时间单位为`SHELL_STATS_TICK()`单位
+ */
+void shellStats(void)
+{
+    SHELL_TypeDef *shell = shellGetCurrent();
+    SHELL_CommandStatDef *stat;
+    unsigned short spaceLength;
+
+    if (!shell)
+    {
+        return;
+    }
+    shellDisplay(shell, shellText[TEXT_STATS_LIST]);
+    for (unsigned short i = 0; i < SHELL_STATS_NUMBER && shellCommandStats[i].command; i++)
+    {
+        stat = &shellCommandStats[i];
+        spaceLength = shellDisplay(shell, stat->command->name);
+        spaceLength = (spaceLength < 22) ? 22 - spaceLength : 4;
+        shellDisplayRepeat(shell, ' ', spaceLength);
+        shellDisplayColumn(shell, stat->count, 10);
+        shellDisplayColumn(shell, stat->min, 10);
+        shellDisplayColumn(shell, stat->max, 10);
+        shellDisplayColumn(shell, stat->total / stat->count, 0);
+        shellDisplay(shell, "\r\n");
+    }
+}
+SHELL_EXPORT_CMD(stats, shellStats, show command stats);
+
+
+/**
+ * @brief shell清除命令统计
+ * 
+ */
+void shellStatsClear(void)
+{
+    memset(shellCommandStats, 0, sizeof(shellCommandStats));
+}
+SHELL_EXPORT_CMD(statsClear, shellStatsClear, clear command stats);
+#endif /** SHELL_USING_STATS == 1 */
 
 
 /**
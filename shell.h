@@ -13,6 +13,7 @@
 #define     __SHELL_H__
 
 #include "shell_cfg.h"
+#include "stddef.h"
 
 #if SHELL_USING_AUTH == 1
     #if !defined(SHELL_USER_PASSWORD)
@@ -20,6 +21,14 @@
     #endif  
 #endif      
 
+#if SHELL_HISTORY_ATTACH == 1 && SHELL_HISTORY_BUFFER_SIZE == 0
+    #error "SHELL_HISTORY_ATTACH requires SHELL_HISTORY_BUFFER_SIZE > 0 (int shell_cfg.h) "
+#endif
+
+#if SHELL_USING_ASYNC == 1 && SHELL_ASYNC_INPUT_SIZE < 2
+    #error "SHELL_USING_ASYNC requires SHELL_ASYNC_INPUT_SIZE >= 2 (int shell_cfg.h) "
+#endif
+
 #define     SHELL_VERSION               "2.0.7"                 /**< 版本号 */
 
 /**
@@ -70,6 +79,31 @@
 #define     SHELL_VAR_CHAR              2
 #define     SHELL_VAR_POINTER           3
 #define     SHELL_VAL                   4
+#define     SHELL_VAR_FLOAT             5
+#define     SHELL_VAR_INT64             6
+#define     SHELL_VAR_ARRAY             0x80
+
+/**
+ * @brief shell数组变量类型
+ *        低7位为元素类型，高位为元素数量
+ */
+#define     SHELL_VAR_ARRAY_OF(type, length)                                \
+            (SHELL_VAR_ARRAY | (type) | ((length) << 8))
+
+/**
+ * @brief shell发送缓冲满处理策略定义
+ * 
+ */
+#define     SHELL_TX_FULL_BLOCK         0
+#define     SHELL_TX_FULL_DROP          1
+#define     SHELL_TX_FULL_OVERWRITE     2
+
+/**
+ * @brief shell返回值显示格式定义
+ * 
+ */
+#define     SHELL_RETURN_DEC            1
+#define     SHELL_RETURN_HEX            2
 
 #if defined(__CC_ARM) || (defined(__ARMCC_VERSION) && __ARMCC_VERSION >= 6000000)
     #define SECTION(x)                  __attribute__((section(x)))
@@ -81,6 +115,40 @@
     #define SECTION(x)
 #endif
 
+/**
+ * @brief shell命令导出段
+ * 
+ * @note 使能`SHELL_COMMAND_SORTED`时，每条命令放在以命令名命名的子段中，
+ *       由链接器按段名排序，具体参考readme
+ */
+#if SHELL_COMMAND_SORTED == 1
+    #define SHELL_COMMAND_SECTION(cmd)  SECTION("shellCommand." #cmd)
+#else
+    #define SHELL_COMMAND_SECTION(cmd)  SECTION("shellCommand")
+#endif
+
+/**
+ * @brief shell命令长帮助占位
+ * 
+ * @note 用于`SHELL_EXPORT_CMD_TYPED`等不带长帮助的命令定义
+ */
+#if SHELL_LONG_HELP == 1
+    #define SHELL_CMD_HELP_NONE         (void *)0,
+#else
+    #define SHELL_CMD_HELP_NONE
+#endif
+
+/**
+ * @brief shell命令参数签名占位
+ * 
+ * @note 用于不带参数签名的命令定义
+ */
+#if SHELL_TYPED_COMMAND == 1
+    #define SHELL_CMD_SIGNATURE_NONE    , (void *)0
+#else
+    #define SHELL_CMD_SIGNATURE_NONE
+#endif
+
 /**
  * @brief shell命令导出
  * 
@@ -92,48 +160,70 @@
             const char shellCmd##cmd[] = #cmd;                              \
             const char shellDesc##cmd[] = #desc;                            \
             const SHELL_CommandTypeDef                                      \
-            shellCommand##cmd SECTION("shellCommand") =                     \
+            shellCommand##cmd SHELL_COMMAND_SECTION(cmd) =                  \
             {                                                               \
                 shellCmd##cmd,                                              \
                 (int (*)())func,                                            \
                 shellDesc##cmd,                                             \
                 (void *)0                                                   \
+                SHELL_CMD_SIGNATURE_NONE                                    \
             }
 #define     SHELL_EXPORT_CMD_EX(cmd, func, desc, help)                      \
             const char shellCmd##cmd[] = #cmd;                              \
             const char shellDesc##cmd[] = #desc;                            \
             const char shellHelp##cmd[] = #help;                            \
             const SHELL_CommandTypeDef                                      \
-            shellCommand##cmd SECTION("shellCommand") =                     \
+            shellCommand##cmd SHELL_COMMAND_SECTION(cmd) =                  \
             {                                                               \
                 shellCmd##cmd,                                              \
                 (int (*)())func,                                            \
                 shellDesc##cmd,                                             \
                 shellHelp##cmd                                              \
+                SHELL_CMD_SIGNATURE_NONE                                    \
             }
 #else /** SHELL_LONG_HELP == 1 */
 #define     SHELL_EXPORT_CMD(cmd, func, desc)                               \
             const char shellCmd##cmd[] = #cmd;                              \
             const char shellDesc##cmd[] = #desc;                            \
             const SHELL_CommandTypeDef                                      \
-            shellCommand##cmd SECTION("shellCommand") =                     \
+            shellCommand##cmd SHELL_COMMAND_SECTION(cmd) =                  \
             {                                                               \
-                shellCmd##cmd                                               \
+                shellCmd##cmd,                                              \
                 (int (*)())func,                                            \
                 shellDesc##cmd                                              \
+                SHELL_CMD_SIGNATURE_NONE                                    \
             }
 #define     SHELL_EXPORT_CMD_EX(cmd, func, desc, help)                      \
             const char shellCmd##cmd[] = #cmd;                              \
             const char shellDesc##cmd[] = #desc;                            \
             const SHELL_CommandTypeDef                                      \
-            shellCommand##cmd SECTION("shellCommand") =                     \
+            shellCommand##cmd SHELL_COMMAND_SECTION(cmd) =                  \
             {                                                               \
                 shellCmd##cmd,                                              \
                 (int (*)())func,                                            \
                 shellDesc##cmd                                              \
+                SHELL_CMD_SIGNATURE_NONE                                    \
             }
 #endif /** SHELL_LONG_HELP == 1 */
 
+#if SHELL_TYPED_COMMAND == 1
+#define     SHELL_EXPORT_CMD_TYPED(cmd, func, desc, signature)              \
+            const char shellCmd##cmd[] = #cmd;                              \
+            const char shellDesc##cmd[] = #desc;                            \
+            const SHELL_CommandTypeDef                                      \
+            shellCommand##cmd SHELL_COMMAND_SECTION(cmd) =                  \
+            {                                                               \
+                shellCmd##cmd,                                              \
+                (int (*)())func,                                            \
+                shellDesc##cmd,                                             \
+                SHELL_CMD_HELP_NONE                                         \
+                signature                                                   \
+            }
+#else
+#define     SHELL_EXPORT_CMD_TYPED(cmd, func, desc, signature)              \
+            SHELL_EXPORT_CMD(cmd, func, desc)
+#endif /** SHELL_TYPED_COMMAND == 1 */
+
 #if SHELL_USING_VAR == 1
     #define SHELL_EXPORT_VAR(var, variable, desc, type)                     \
             const char shellVar##var[] = #var;                              \
@@ -153,6 +243,7 @@
 #else
 #define     SHELL_EXPORT_CMD(cmd, func, desc)
 #define     SHELL_EXPORT_CMD_EX(cmd, func, desc, help)
+#define     SHELL_EXPORT_CMD_TYPED(cmd, func, desc, signature)
 #define     SHELL_EXPORT_VAR(var, variable, desc, type) 
 #endif /** SHELL_USING_CMD_EXPORT == 1 */
 
@@ -166,14 +257,21 @@
             SHELL_EXPORT_VAR(var, variable, desc, SHELL_VAR_POINTER)
 #define     SHELL_EXPORT_VAL(val, value, desc)                              \
             SHELL_EXPORT_VAR(val, value, desc, SHELL_VAL)
+#define     SHELL_EXPORT_VAR_FLOAT(var, variable, desc)                     \
+            SHELL_EXPORT_VAR(var, &variable, desc, SHELL_VAR_FLOAT)
+#define     SHELL_EXPORT_VAR_INT64(var, variable, desc)                     \
+            SHELL_EXPORT_VAR(var, &variable, desc, SHELL_VAR_INT64)
+#define     SHELL_EXPORT_VAR_ARRAY(var, variable, desc, type)               \
+            SHELL_EXPORT_VAR(var, variable, desc,                           \
+                SHELL_VAR_ARRAY_OF(type, sizeof(variable) / sizeof((variable)[0])))
 
 
 /**
  * @brief shell命令条目
  * 
- * @note 用于shell命令通过命令表的方式定义
+ * @note 用于shell命令通过命令表的方式定义，使用共享命令注册表时也用于定义运行时注册的命令
  */
-#if SHELL_USING_CMD_EXPORT == 0
+#if SHELL_USING_CMD_EXPORT == 0 || SHELL_USING_REGISTRY == 1
 #if SHELL_LONG_HELP == 1
 #define     SHELL_CMD_ITEM(cmd, func, desc)                                 \
             {                                                               \
@@ -181,6 +279,7 @@
                 (int (*)())func,                                            \
                 #desc,                                                      \
                 (void *)0                                                   \
+                SHELL_CMD_SIGNATURE_NONE                                    \
             }
 #define     SHELL_CMD_ITEM_EX(cmd, func, desc, help)                        \
             {                                                               \
@@ -188,6 +287,7 @@
                 (int (*)())func,                                            \
                 #desc,                                                      \
                 #help                                                       \
+                SHELL_CMD_SIGNATURE_NONE                                    \
             }   
 #else /** SHELL_LONG_HELP == 1 */
 #define     SHELL_CMD_ITEM(cmd, func, desc)                                 \
@@ -195,19 +295,35 @@
                 #cmd,                                                       \
                 (int (*)())func,                                            \
                 #desc                                                       \
+                SHELL_CMD_SIGNATURE_NONE                                    \
             }
 #define     SHELL_CMD_ITEM_EX(cmd, func, desc, help)                        \
             {                                                               \
                 #cmd,                                                       \
                 (int (*)())func,                                            \
-                #desc,                                                      \
+                #desc                                                       \
+                SHELL_CMD_SIGNATURE_NONE                                    \
             }  
 #endif /** SHELL_LONG_HELP == 1 */
 
+#if SHELL_TYPED_COMMAND == 1
+#define     SHELL_CMD_ITEM_TYPED(cmd, func, desc, signature)                \
+            {                                                               \
+                #cmd,                                                       \
+                (int (*)())func,                                            \
+                #desc,                                                      \
+                SHELL_CMD_HELP_NONE                                         \
+                signature                                                   \
+            }
+#else
+#define     SHELL_CMD_ITEM_TYPED(cmd, func, desc, signature)                \
+            SHELL_CMD_ITEM(cmd, func, desc)
+#endif /** SHELL_TYPED_COMMAND == 1 */
+
 #define     SHELL_VAR_ITEM(var, variable, desc, type)                       \
             {                                                               \
                 #var,                                                       \
-                varialbe,                                                   \
+                (void *)(variable),                                         \
                 #desc,                                                      \
                 type,                                                       \
             }
@@ -219,8 +335,15 @@
             SHELL_VAR_ITEM(var, &variable, desc, SHELL_VAR_CHAR)
 #define     SHELL_VAR_ITEM_POINTER(var, variable, desc)                     \
             SHELL_VAR_ITEM(var, variable, desc, SHELL_VAR_POINTER)
+#define     SHELL_VAR_ITEM_FLOAT(var, variable, desc)                       \
+            SHELL_VAR_ITEM(var, &variable, desc, SHELL_VAR_FLOAT)
+#define     SHELL_VAR_ITEM_INT64(var, variable, desc)                       \
+            SHELL_VAR_ITEM(var, &variable, desc, SHELL_VAR_INT64)
+#define     SHELL_VAR_ITEM_ARRAY(var, variable, desc, type)                 \
+            SHELL_VAR_ITEM(var, variable, desc,                             \
+                SHELL_VAR_ARRAY_OF(type, sizeof(variable) / sizeof((variable)[0])))
 
-#endif /** SHELL_USING_CMD_EXPORT == 0 */
+#endif /** SHELL_USING_CMD_EXPORT == 0 || SHELL_USING_REGISTRY == 1 */
 
 /**
  * @brief shell读取数据函数原型
@@ -232,6 +355,18 @@
  */
 typedef signed char (*shellRead)(char *);
 
+/**
+ * @brief shell块读数据函数原型
+ * 
+ * @param char* 读取数据的缓冲
+ * @param unsigned short 缓冲大小
+ * 
+ * @return unsigned short 读取到的数据长度，超时或者无数据时返回0
+ * 
+ * @note 无数据时应阻塞等待(如等待串口接收中断释放的信号量)，避免`shellTask()`空转
+ */
+typedef unsigned short (*shellReadBuffer)(char *, unsigned short);
+
 /**
  * @brief shell写数据函数原型
  * 
@@ -239,6 +374,14 @@ typedef signed char (*shellRead)(char *);
  */
 typedef void (*shellWrite)(const char);
 
+/**
+ * @brief shell块写数据函数原型
+ * 
+ * @param const char* 需写的数据
+ * @param unsigned short 数据长度
+ */
+typedef void (*shellWriteBuffer)(const char *, unsigned short);
+
 /**
  * @brief shell指令执行函数原型
  * 
@@ -255,8 +398,116 @@ typedef enum
     SHELL_IN_NORMAL = 0,
     SHELL_ANSI_ESC,
     SHELL_ANSI_CSI,
+    SHELL_ANSI_SS3,
 }SHELL_InputMode;
 
+/**
+ * @brief shell参数类型
+ * 
+ */
+typedef enum
+{
+    SHELL_PARAM_STRING = 0,                                     /**< 字符串 */
+    SHELL_PARAM_NUMBER,                                         /**< 数字 */
+    SHELL_PARAM_CHAR,                                           /**< 字符 */
+    SHELL_PARAM_VAR,                                            /**< 变量 */
+} SHELL_ParamType;
+
+#if SHELL_USING_PIPE == 1
+/**
+ * @brief shell管道过滤类型
+ */
+typedef enum
+{
+    SHELL_PIPE_GREP = 0,                                        /**< 保留包含关键字的行 */
+    SHELL_PIPE_HEAD,                                            /**< 保留前n行 */
+} SHELL_PipeType;
+#endif /** SHELL_USING_PIPE == 1 */
+
+#if SHELL_USING_REDIRECT == 1
+/**
+ * @brief shell输出目标定义
+ * 
+ * @note 重定向时，shell的输出通过`write`写入输出目标，`param`由输出目标自行使用，
+ *       如内存缓冲，RTT通道号，日志环形缓冲等
+ */
+typedef struct SHELL_Sink
+{
+    const char *name;                                           /**< 输出目标名 */
+    void (*write)(struct SHELL_Sink *, const char *, unsigned short); /**< 输出目标写数据 */
+    void *param;                                                /**< 输出目标参数 */
+} SHELL_SinkTypeDef;
+
+/**
+ * @brief shell内存输出目标缓冲定义
+ * 
+ * @note 配合`shellSinkBufferWrite`使用，写满后丢弃后续数据，数据始终以'\0'结尾
+ */
+typedef struct
+{
+    char *buffer;                                               /**< 缓冲区 */
+    unsigned short size;                                        /**< 缓冲区大小 */
+    unsigned short length;                                      /**< 已写入数据长度 */
+} SHELL_SinkBufferDef;
+
+#define     SHELL_SINK_ITEM(sink, write, param)                             \
+            {                                                               \
+                #sink,                                                      \
+                write,                                                      \
+                (void *)(param),                                            \
+            }
+#define     SHELL_SINK_ITEM_BUFFER(sink, buffer)                            \
+            SHELL_SINK_ITEM(sink, shellSinkBufferWrite, &buffer)
+#endif /** SHELL_USING_REDIRECT == 1 */
+
+#if SHELL_USING_MACHINE == 1
+/**
+ * @brief shell机器模式帧定义
+ * 
+ * @note 帧格式: | SOF | 类型 | 序号 | 长度 | 数据(长度字节) | 校验 |
+ *       校验为类型，序号，长度以及数据的异或值
+ */
+#define     SHELL_MACHINE_SOF           0xA5                    /**< 帧起始 */
+#define     SHELL_MACHINE_COMMAND       'C'                     /**< 请求: 执行命令 */
+#define     SHELL_MACHINE_EXIT          'X'                     /**< 请求: 退出机器模式 */
+#define     SHELL_MACHINE_LIST          'L'                     /**< 请求: 获取命令表 */
+#define     SHELL_MACHINE_INVOKE        'I'                     /**< 请求: 按索引调用命令 */
+#define     SHELL_MACHINE_CANCEL        'K'                     /**< 请求: 取消正在执行的请求 */
+#define     SHELL_MACHINE_ENTRY         'E'                     /**< 响应: 命令表条目 */
+#define     SHELL_MACHINE_OUTPUT        'O'                     /**< 响应: 命令输出 */
+#define     SHELL_MACHINE_RESULT        'R'                     /**< 响应: 执行结果 */
+#define     SHELL_MACHINE_WATCH         'W'                     /**< 响应: 变量监视数据 */
+
+/**
+ * @brief shell机器模式帧数据最大长度
+ * 
+ * @note 请求帧数据需小于命令缓冲长度，响应帧与之一致，且不超过长度字段的范围
+ */
+#define     SHELL_MACHINE_DATA_SIZE     ((SHELL_COMMAND_MAX_LENGTH - 1) < 255 \
+                                         ? (SHELL_COMMAND_MAX_LENGTH - 1) : 255)
+
+/**
+ * @brief shell机器模式执行状态
+ * 
+ * @note 结果帧数据为1字节状态和4字节小端序返回值
+ */
+typedef enum
+{
+    SHELL_MACHINE_OK = 0,                                       /**< 执行成功 */
+    SHELL_MACHINE_NOT_FOUND,                                    /**< 命令不存在 */
+    SHELL_MACHINE_CHECK_ERROR,                                  /**< 校验错误 */
+    SHELL_MACHINE_TOO_LONG,                                     /**< 命令过长 */
+    SHELL_MACHINE_UNKNOWN,                                      /**< 未知请求 */
+    SHELL_MACHINE_PARAM_ERROR,                                  /**< 参数错误 */
+} SHELL_MachineStatus;
+#endif /** SHELL_USING_MACHINE == 1 */
+
+/**
+ * @brief shell ansi控制序列最大参数数量
+ * 
+ */
+#define     SHELL_ANSI_PARAM_NUMBER     2
+
 
 /**
  * @brief shell 命令定义
@@ -270,6 +521,9 @@ typedef struct
 #if SHELL_LONG_HELP == 1
     const char *help;                                           /**< shell长帮助信息 */
 #endif
+#if SHELL_TYPED_COMMAND == 1
+    const char *signature;                                      /**< shell命令参数签名 */
+#endif
 }SHELL_CommandTypeDef;
 
 
@@ -288,6 +542,21 @@ typedef struct
 #endif /** SHELL_USING_VAR == 1 */
 
 
+#if SHELL_USING_STATS == 1
+/**
+ * @brief shell命令统计定义
+ */
+typedef struct
+{
+    const SHELL_CommandTypeDef *command;                        /**< 统计的命令，为NULL时条目未使用 */
+    unsigned int count;                                         /**< 执行次数 */
+    unsigned int min;                                           /**< 最短执行时间 */
+    unsigned int max;                                           /**< 最长执行时间 */
+    unsigned int total;                                         /**< 总执行时间 */
+} SHELL_CommandStatDef;
+#endif /** SHELL_USING_STATS == 1 */
+
+
 /**
  * @brief shell对象定义
  * 
@@ -299,30 +568,146 @@ typedef struct
     unsigned short length;                                      /**< shell命令长度 */
     unsigned short cursor;                                      /**< shell光标位置 */
     char *param[SHELL_PARAMETER_MAX_NUMBER];                    /**< shell参数 */
+    unsigned char paramType[SHELL_PARAMETER_MAX_NUMBER];        /**< shell参数类型 */
+    unsigned short paramLength[SHELL_PARAMETER_MAX_NUMBER];     /**< shell参数长度 */
+#if SHELL_HISTORY_BUFFER_SIZE > 0
+#if SHELL_HISTORY_ATTACH == 1
+    char *history;                                              /**< 历史记录缓冲，为NULL时不记录历史 */
+#else
+    char history[SHELL_HISTORY_BUFFER_SIZE];                    /**< 历史记录，以'\0'分隔，从新到旧存放 */
+#endif /** SHELL_HISTORY_ATTACH == 1 */
+    unsigned short historyLength;                               /**< 历史记录占用长度 */
+#else
     char history[SHELL_HISTORY_MAX_NUMBER][SHELL_COMMAND_MAX_LENGTH];  /**< 历史记录 */
-    unsigned short historyCount;                                /**< 历史记录数量 */
     short historyFlag;                                          /**< 当前记录位置 */
+#endif /** SHELL_HISTORY_BUFFER_SIZE > 0 */
+    unsigned short historyCount;                                /**< 历史记录数量 */
     short historyOffset;                                        /**< 历史记录偏移 */
     SHELL_CommandTypeDef *commandBase;                          /**< 命令表基址 */
     unsigned short commandNumber;                               /**< 命令数量 */
 #if SHELL_USING_VAR == 1
     SHELL_VaribaleTypeDef *variableBase;                        /**< 变量表基址 */
     unsigned short variableNumber;                              /**< 变量数量 */
+#if SHELL_WATCH_NUMBER > 0
+    struct
+    {
+        SHELL_VaribaleTypeDef *variable[SHELL_WATCH_NUMBER];    /**< 监视的变量 */
+        short element[SHELL_WATCH_NUMBER];                      /**< 监视的数组元素下标 */
+        unsigned char number;                                   /**< 监视的变量数量 */
+        unsigned char active : 1;                               /**< 是否正在输出 */
+        unsigned char binary : 1;                               /**< 是否使用二进制输出 */
+        unsigned int period;                                    /**< 输出周期 */
+        unsigned int last;                                      /**< 上次输出时间 */
+    } watch;                                                    /**< shell变量监视 */
+#endif /** SHELL_WATCH_NUMBER > 0 */
 #endif
-    int keyFuncBase;                                            /**< 按键响应表基址 */
+    struct SHELL_KeyFunction *keyFuncBase;                      /**< 按键响应表基址 */
     unsigned short keyFuncNumber;                               /**< 按键响应数量 */
+#if SHELL_KEY_TABLE_SIZE > 0
+    const struct SHELL_KeyFunction *keyTable[SHELL_KEY_TABLE_SIZE]; /**< 按键响应查找表 */
+#endif
     struct
     {
-        char inputMode : 2;                                     /**< 输入模式 */
-        char tabFlag : 1;                                       /**< tab标志 */
-        char authFlag : 1;                                      /**< 密码标志 */
+        unsigned char inputMode : 4;                            /**< 输入模式 */
+        unsigned char tabFlag : 1;                              /**< tab标志 */
+        unsigned char authFlag : 1;                             /**< 密码标志 */
+        unsigned char commandSorted : 1;                        /**< 命令表已按命令名排序 */
+        unsigned char machineMode : 1;                          /**< 机器模式 */
+        unsigned char searchMode : 1;                           /**< 历史记录搜索模式 */
+#if SHELL_INIT_DEFERRED == 1
+        unsigned char startPending : 1;                         /**< 初始化信息等待显示 */
+#endif /** SHELL_INIT_DEFERRED == 1 */
     } status;                                                   /**< shell状态 */
+#if SHELL_USING_PIPE == 1
+    struct
+    {
+        struct
+        {
+            unsigned char type;                                 /**< 过滤类型 */
+            unsigned short count;                               /**< 已通过的行数 */
+            unsigned short max;                                 /**< 最大行数 */
+            char pattern[SHELL_PIPE_PATTERN_LENGTH];            /**< 过滤关键字 */
+        } stage[SHELL_PIPE_STAGE_NUMBER];                       /**< 管道各级过滤 */
+        unsigned char number;                                   /**< 管道级数，为0时未使用管道 */
+        unsigned short length;                                  /**< 行缓冲数据长度 */
+        char line[SHELL_PIPE_LINE_LENGTH];                      /**< 行缓冲 */
+    } pipe;                                                     /**< shell管道 */
+#endif /** SHELL_USING_PIPE == 1 */
+#if SHELL_USING_REDIRECT == 1
+    SHELL_SinkTypeDef *sink;                                    /**< 当前输出目标，为NULL时正常输出 */
+    SHELL_SinkTypeDef *sinkBase;                                /**< 输出目标表基址 */
+    unsigned short sinkNumber;                                  /**< 输出目标数量 */
+#endif /** SHELL_USING_REDIRECT == 1 */
+#if SHELL_HISTORY_SEARCH == 1
+    struct
+    {
+        unsigned short index;                                   /**< 匹配的历史记录序号 */
+        unsigned short display;                                 /**< 搜索行显示长度 */
+        unsigned char found;                                    /**< 是否有匹配的记录 */
+        unsigned char failed;                                   /**< 最近一次匹配是否失败 */
+    } search;                                                   /**< shell历史记录搜索 */
+#endif /** SHELL_HISTORY_SEARCH == 1 */
+    struct
+    {
+        unsigned char param[SHELL_ANSI_PARAM_NUMBER];           /**< 控制序列参数 */
+        unsigned char paramCount;                               /**< 控制序列参数数量 */
+    } ansi;                                                     /**< shell ansi控制序列 */
+#if SHELL_USING_MACHINE == 1
+    struct
+    {
+        unsigned char state;                                    /**< 帧接收状态 */
+        unsigned char type;                                     /**< 帧类型 */
+        unsigned char seq;                                      /**< 帧序号 */
+        unsigned char length;                                   /**< 帧数据长度 */
+        unsigned char index;                                    /**< 已接收数据长度 */
+        unsigned char check;                                    /**< 校验值 */
+    } machine;                                                  /**< shell机器模式 */
+#endif
+#if SHELL_USING_ASYNC == 1
+    struct
+    {
+        volatile unsigned char busy;                            /**< 命令等待或正在执行，输入进入缓冲 */
+        volatile unsigned char pending;                         /**< 有命令等待执行 */
+        volatile unsigned char cancel;                          /**< 命令取消请求 */
+        unsigned char paramCount;                               /**< 命令参数数量 */
+#if SHELL_USING_MACHINE == 1
+        unsigned char request;                                  /**< 等待执行的机器模式请求类型，0为命令行输入 */
+        struct
+        {
+            unsigned char state;                                /**< 帧接收状态 */
+            unsigned char type;                                 /**< 帧类型 */
+            unsigned char length;                               /**< 帧数据长度 */
+            unsigned char index;                                /**< 已接收数据长度 */
+            unsigned char check;                                /**< 校验值 */
+            unsigned char drop;                                 /**< 缓冲已满，丢弃当前帧 */
+        } frame;                                                /**< 执行期间收到的帧 */
+#endif /** SHELL_USING_MACHINE == 1 */
+        char input[SHELL_ASYNC_INPUT_SIZE];                     /**< 执行期间的输入缓冲 */
+        volatile unsigned short head;                           /**< 已提交的写入位置 */
+        volatile unsigned short tail;                           /**< 读取位置 */
+        unsigned short write;                                   /**< 写入位置，机器模式下收到完整帧才提交 */
+    } async;                                                    /**< shell异步命令 */
+#endif
     unsigned char isActive;                                     /**< 是否是当前活动shell */
     shellRead read;                                             /**< shell读字符 */
+    shellReadBuffer readBuffer;                                 /**< shell块读数据 */
     shellWrite write;                                           /**< shell写字符 */
+    shellWriteBuffer writeBuffer;                               /**< shell块写数据 */
+#if SHELL_USING_TELNET == 1
+    void *session;                                              /**< shell所属的telnet会话，为NULL时不使用 */
+#endif /** SHELL_USING_TELNET == 1 */
 #if SHELL_LONG_HELP == 1 || (SHELL_USING_AUTH && SHELL_LOCK_TIMEOUT > 0)
     int activeTime;                                             /**< shell激活时间戳 */
 #endif
+#if SHELL_TX_BUFFER_SIZE > 0
+    struct
+    {
+        char buffer[SHELL_TX_BUFFER_SIZE];                      /**< 发送缓冲 */
+        volatile unsigned short head;                           /**< 缓冲写入位置 */
+        volatile unsigned short tail;                           /**< 缓冲读出位置 */
+        volatile unsigned short sending;                        /**< 正在发送的长度 */
+    } tx;                                                       /**< shell发送缓冲 */
+#endif
 }SHELL_TypeDef;
 
 
@@ -330,7 +715,7 @@ typedef struct
  * @brief shell按键功能定义
  * 
  */
-typedef struct
+typedef struct SHELL_KeyFunction
 {
     unsigned char keyCode;                                      /**< shell按键键值 */
     void (*keyFunction)(SHELL_TypeDef *);                       /**< 按键响应函数 */
@@ -338,22 +723,59 @@ typedef struct
 
 
 void shellInit(SHELL_TypeDef *shell);
+void shellRemove(SHELL_TypeDef *shell);
 void shellSetCommandList(SHELL_TypeDef *shell, SHELL_CommandTypeDef *base, unsigned short size);
+#if SHELL_USING_REGISTRY == 1
+int shellRegisterCommand(SHELL_CommandTypeDef *command);
+#endif /** SHELL_USING_REGISTRY == 1 */
 
 #if SHELL_USING_VAR == 1
 void shellSetVariableList(SHELL_TypeDef *shell, SHELL_VaribaleTypeDef *base, unsigned short size);
 int shellGetVariable(SHELL_TypeDef *shell, char *var);
+float shellGetVariableFloat(SHELL_TypeDef *shell, char *var);
+#if SHELL_WATCH_NUMBER > 0
+void shellWatchTick(SHELL_TypeDef *shell);
+#endif /** SHELL_WATCH_NUMBER > 0 */
 #endif /** SHELL_USING_VAR == 1 */
 
 void shellSetKeyFuncList(SHELL_TypeDef *shell, SHELL_KeyFunctionDef *base, unsigned short size);
+#if SHELL_HISTORY_ATTACH == 1
+void shellSetHistoryBuffer(SHELL_TypeDef *shell, char *buffer);
+#endif /** SHELL_HISTORY_ATTACH == 1 */
 SHELL_TypeDef *shellGetCurrent(void);
 void shellPrint(SHELL_TypeDef *shell, char *fmt, ...);
 unsigned short shellDisplay(SHELL_TypeDef *shell, const char *string);
 void shellHandler(SHELL_TypeDef *shell, char data);
+void shellHandlerBuffer(SHELL_TypeDef *shell, const char *data, unsigned short length);
+int shellExecScript(SHELL_TypeDef *shell, const char *script, unsigned int length);
+#if SHELL_USING_MACHINE == 1
+void shellSetMachineMode(SHELL_TypeDef *shell, unsigned char enable);
+#endif
+#if SHELL_USING_ASYNC == 1
+int shellAsyncRun(SHELL_TypeDef *shell);
+unsigned char shellCancelled(SHELL_TypeDef *shell);
+#endif
+#if SHELL_USING_REDIRECT == 1
+void shellSetSinkList(SHELL_TypeDef *shell, SHELL_SinkTypeDef *base, unsigned short size);
+SHELL_SinkTypeDef *shellRedirect(SHELL_TypeDef *shell, SHELL_SinkTypeDef *sink);
+void shellSinkBufferWrite(SHELL_SinkTypeDef *sink, const char *data, unsigned short length);
+#endif /** SHELL_USING_REDIRECT == 1 */
+#if SHELL_TX_BUFFER_SIZE > 0
+void shellTxDrain(SHELL_TypeDef *shell);
+void shellTxComplete(SHELL_TypeDef *shell);
+#endif
 #define     shellInput      shellHandler
+#define     shellInputBuffer    shellHandlerBuffer
 
 void shellHelp(int argc, char *argv[]);
 void shellClear(void);
+#if SHELL_AUTO_PRASE == 1
+int shellSource(size_t address, unsigned int length);
+#endif /** SHELL_AUTO_PRASE == 1 */
+#if SHELL_USING_STATS == 1
+void shellStats(void);
+void shellStatsClear(void);
+#endif /** SHELL_USING_STATS == 1 */
 
 #if SHELL_USING_TASK == 1
 void shellTask(void *param);
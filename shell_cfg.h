@@ -25,6 +25,13 @@
  */
 #define     SHELL_TASK_WHILE            1
 
+/**
+ * @brief shell任务读缓冲大小
+ *        定义了`shell->readBuffer`时，`shellTask()`每次最多读取此长度的数据，
+ *        然后交给`shellInputBuffer()`批量处理，读缓冲位于`shellTask()`的栈中
+ */
+#define     SHELL_READ_BUFFER_SIZE      32
+
 /**
  * @brief 是否使用命令导出方式
  *        使能此宏后，可以使用`SHELL_EXPORT_CMD()`或者`SHELL_EXPORT_CMD_EX()`
@@ -38,19 +45,73 @@
  */
 #define     SHELL_USING_VAR             0
 
+/**
+ * @brief shell变量索引最大数量
+ *        使能宏`SHELL_USING_VAR`后此宏生效，不为0时，初始化时会对变量表建立按变量名排序的索引，
+ *        变量查找使用二分查找，索引由使用同一变量表的shell共享，变量数量超过此值时使用顺序查找
+ */
+#define     SHELL_VARIABLE_INDEX_MAX    0
+
+/**
+ * @brief 是否使用扩展变量类型
+ *        使能宏`SHELL_USING_VAR`后此宏生效，使能后支持浮点，64位整型和定长数组类型的变量，
+ *        会引入浮点和64位整型运算
+ */
+#define     SHELL_VAR_EXTENDED          0
+
+/**
+ * @brief shell变量监视的最大数量
+ *        使能宏`SHELL_USING_VAR`后此宏生效，不为0时可以使用`watch`命令添加监视变量，
+ *        `watchStart`命令开始输出，输出由在shell所在任务中周期性调用的`shellWatchTick()`完成，
+ *        为0时不使用变量监视
+ */
+#define     SHELL_WATCH_NUMBER          0
+
 /**
  * @brief 是否显示命令调用函数返回值
  *        使能此宏，则每次调用shell命令之后会以整形和十六进制的方式打印函数的返回值
  */
 #define     SHELL_DISPLAY_RETURN        1
 
+/**
+ * @brief 命令返回值显示格式
+ *        使能宏`SHELL_DISPLAY_RETURN`后此宏生效
+ *        SHELL_RETURN_DEC 十进制
+ *        SHELL_RETURN_HEX 十六进制
+ *        可以组合使用，如(SHELL_RETURN_DEC | SHELL_RETURN_HEX)
+ */
+#define     SHELL_RETURN_FORMAT         (SHELL_RETURN_DEC | SHELL_RETURN_HEX)
+
 /**
  * @brief 是否使用shell参数自动解析
  *        使能此宏以支持常规C函数形式的命令，shell会自动转换参数
  *        关闭此宏则支持main函数形式的命令，需要自行在函数中处理参数
+ *        浮点参数的十进制尾数超过2^24或指数超过10时，经double计算后转换为float，
+ *        结果与strtof可能相差1ulp，整型超出32位时不执行命令
  */
 #define     SHELL_AUTO_PRASE            1
 
+/**
+ * @brief 是否使用带类型签名的命令
+ *        使能此宏后，可以使用`SHELL_EXPORT_CMD_TYPED()`定义带参数签名的命令，
+ *        参数按签名转换后以正确的类型传递，支持浮点参数，使能宏`SHELL_AUTO_PRASE`后此宏有意义
+ */
+#define     SHELL_TYPED_COMMAND         0
+
+/**
+ * @brief 是否使用机器模式
+ *        使能此宏后，shell可以通过`shellSetMachineMode()`或者控制序列`ESC[99~`进入机器模式，
+ *        机器模式下关闭回显，提示符和ansi控制序列处理，请求和响应均使用带序号的帧传输，具体参考readme
+ */
+#define     SHELL_USING_MACHINE         0
+
+/**
+ * @brief 是否使用ansi控制序列编辑命令行
+ *        使能此宏后，插入，删除以及光标移动使用ansi控制序列(`ESC[@`，`ESC[P`，`ESC[nD`，
+ *        `ESC[K`)完成，每次编辑的输出长度固定，不再重新输出光标后的内容，终端需支持这些控制序列
+ */
+#define     SHELL_ANSI_EDIT             0
+
 /**
  * @brief 是否使用shell长帮助
  *        使能此宏以支持命令的长帮助信息
@@ -69,28 +130,241 @@
  */
 #define     SHELL_PARAMETER_MAX_NUMBER  8
 
+/**
+ * @brief shell命令索引最大数量
+ *        不为0时，初始化时会对命令表建立按命令名排序的索引，命令查找和tab补全使用二分查找，
+ *        索引由使用同一命令表的shell共享，命令数量超过此值时使用顺序查找
+ *        为0时不使用命令索引
+ */
+#define     SHELL_COMMAND_INDEX_MAX     0
+
+/**
+ * @brief shell命令表是否按命令名排序
+ *        使能此宏后，导出的命令放在以命令名命名的子段中，配合链接脚本按段名排序，
+ *        初始化时检查命令表，已排序的命令表直接使用二分查找，不占用索引内存，
+ *        链接脚本配置参考readme
+ */
+#define     SHELL_COMMAND_SORTED        0
+
 /**
  * @brief 历史命令记录数量
  */
 #define     SHELL_HISTORY_MAX_NUMBER    5
 
+/**
+ * @brief 历史记录缓冲大小
+ *        为0时每条历史记录占用`SHELL_COMMAND_MAX_LENGTH`字节，共`SHELL_HISTORY_MAX_NUMBER`条，
+ *        不为0时历史记录按实际长度紧凑存放在此大小的缓冲中，缓冲满时丢弃最旧的记录，
+ *        此时`SHELL_HISTORY_MAX_NUMBER`不再生效，每条记录占用命令长度 + 1字节
+ */
+#define     SHELL_HISTORY_BUFFER_SIZE   0
+
+/**
+ * @brief 是否使用外部历史记录缓冲
+ *        使能后shell对象中只保存历史记录缓冲的指针，缓冲通过`shellSetHistoryBuffer()`设置，
+ *        未设置缓冲的shell不记录历史，多个shell可以从缓冲池中按需获取缓冲，
+ *        需要`SHELL_HISTORY_BUFFER_SIZE`不为0，缓冲大小为`SHELL_HISTORY_BUFFER_SIZE`
+ */
+#define     SHELL_HISTORY_ATTACH        0
+
+/**
+ * @brief 是否使用历史记录搜索
+ *        使能后，按下`Ctrl+R`进入反向搜索，输入的内容作为关键字从新到旧匹配历史记录，
+ *        再次按下`Ctrl+R`查找下一条，回车执行匹配的命令，`Ctrl+C`或`Ctrl+G`退出搜索，
+ *        其他控制键将匹配的命令放入命令行后继续处理
+ */
+#define     SHELL_HISTORY_SEARCH        0
+
+/**
+ * @brief shell按键响应查找表大小
+ *        不为0时，每个shell建立按键值直接索引的按键响应表，按键查找只需一次查表，
+ *        设为32时只对控制字符建表，设为256时对所有字符建表，为0时顺序查找按键响应表
+ */
+#define     SHELL_KEY_TABLE_SIZE        0
+
 /**
  * @brief 双击间隔(ms)
  *        使能宏`SHELL_LONG_HELP`后此宏生效，定义双击tab补全help的时间间隔
  */
 #define     SHELL_DOUBLE_CLICK_TIME     200
 
+/**
+ * @brief 是否使用共享命令注册表
+ *        使能后命令表和变量表只在第一次调用`shellInit()`时解析，排序检查和索引也只建立一次，
+ *        所有shell共用，之后的`shellInit()`不再遍历命令表，可以使用`shellRegisterCommand()`
+ *        在运行时注册命令
+ */
+#define     SHELL_USING_REGISTRY        0
+
+/**
+ * @brief 运行时注册命令的最大数量
+ *        使能宏`SHELL_USING_REGISTRY`后此宏生效
+ */
+#define     SHELL_REGISTRY_COMMAND_NUMBER 8
+
+/**
+ * @brief 是否延迟显示shell初始化信息
+ *        使能后`shellInit()`不产生输出，shell信息和提示符(或密码提示)在shell第一次处理输入时显示
+ */
+#define     SHELL_INIT_DEFERRED         0
+
 /**
  * @brief 管理的最大shell数量
  */
 #define     SHELL_MAX_NUMBER            5
 
+/**
+ * @brief 当前shell指针的线程局部存储修饰
+ *        多个shell在不同任务中同时执行命令时，定义为编译器的线程局部存储关键字，
+ *        如`__thread`，`_Thread_local`，每个任务通过`shellGetCurrent()`获取各自的shell，
+ *        为空时所有任务共用一个当前shell指针
+ */
+#define     SHELL_THREAD_LOCAL
+
+/**
+ * @brief shell列表锁
+ *        多个任务同时调用`shellInit()`时，需要定义为互斥锁或临界区的获取/释放，
+ *        使能宏`SHELL_USING_REGISTRY`后，查找命令和补全也会获取此锁，与`shellRegisterCommand()`互斥，
+ *        锁不会嵌套获取
+ */
+#define     SHELL_LIST_LOCK()
+#define     SHELL_LIST_UNLOCK()
+
+/**
+ * @brief 是否使用异步命令执行
+ *        使能后，命令不在输入处理中执行，而是通过`SHELL_ASYNC_NOTIFY`通知工作任务，
+ *        由工作任务调用`shellAsyncRun()`执行，命令执行期间输入的`Ctrl+C`(机器模式下为取消请求帧)
+ *        会请求取消命令，其他输入先缓存，命令结束后再处理
+ */
+#define     SHELL_USING_ASYNC           0
+
+/**
+ * @brief 异步命令执行期间的输入缓冲大小
+ *        使能宏`SHELL_USING_ASYNC`后此宏生效，缓冲满后新的输入被丢弃，
+ *        机器模式下按整帧缓存，放不下的帧整帧丢弃，不会收到结果帧，
+ *        需要缓存完整的请求帧时应不小于`SHELL_COMMAND_MAX_LENGTH + 5`
+ */
+#define     SHELL_ASYNC_INPUT_SIZE      64
+
+/**
+ * @brief 异步命令通知
+ *        使能宏`SHELL_USING_ASYNC`后此宏生效，有命令等待执行时调用，
+ *        一般定义为释放工作任务的信号量，为空时需要在主循环中轮询调用`shellAsyncRun()`
+ */
+#define     SHELL_ASYNC_NOTIFY(shell)
+
 /**
  * @brief shell格式化输出的缓冲大小
  *        为0时不使用shell格式化输出
  */
 #define     SHELL_PRINT_BUFFER          128
 
+/**
+ * @brief 是否使用流式格式化输出
+ *        使能后`shellPrint`使用shell内置的格式化，不使用`vsnprintf`，格式化结果按块写出，
+ *        输出长度不受`SHELL_PRINT_BUFFER`限制，支持`%d %i %u %x %X %o %c %s %p %%`，
+ *        `- 0 + #`和空格标志，宽度，精度以及`hh h l z t`修饰，结果与`vsnprintf`一致，
+ *        浮点和`ll`等其他转换说明原样输出
+ */
+#define     SHELL_PRINT_STREAM          0
+
+/**
+ * @brief 流式格式化输出的块大小
+ *        使能宏`SHELL_PRINT_STREAM`后此宏生效，格式化结果每满一块写出一次
+ */
+#define     SHELL_PRINT_CHUNK           16
+
+/**
+ * @brief 是否使用管道过滤命令输出
+ *        使能后可以使用`command | grep [pattern]`，`command | head [n]`过滤命令输出，
+ *        输出按行经过各级过滤后再写出，不需要缓存完整的输出
+ */
+#define     SHELL_USING_PIPE            0
+
+/**
+ * @brief 管道最大级数
+ *        使能宏`SHELL_USING_PIPE`后此宏生效
+ */
+#define     SHELL_PIPE_STAGE_NUMBER     2
+
+/**
+ * @brief 管道行缓冲大小
+ *        使能宏`SHELL_USING_PIPE`后此宏生效，超过此长度的行会被分成多行过滤
+ */
+#define     SHELL_PIPE_LINE_LENGTH      64
+
+/**
+ * @brief 管道过滤关键字最大长度
+ *        使能宏`SHELL_USING_PIPE`后此宏生效，包括结尾的'\0'
+ */
+#define     SHELL_PIPE_PATTERN_LENGTH   16
+
+/**
+ * @brief 是否使用输出重定向
+ *        使能后可以使用`command > [sink]`将命令输出写入注册的输出目标，
+ *        也可以调用`shellRedirect()`在一段时间内重定向shell的全部输出
+ */
+#define     SHELL_USING_REDIRECT        0
+
+/**
+ * @brief shell发送缓冲大小
+ *        为0时不使用发送缓冲，输出直接写出，不为0时，输出先存入发送缓冲，由`shellTxDrain()`
+ *        发送，定义了`shell->writeBuffer`时，缓冲数据会被自动交给`shell->writeBuffer`异步发送，
+ *        发送完成后需要调用`shellTxComplete()`
+ */
+#define     SHELL_TX_BUFFER_SIZE        0
+
+/**
+ * @brief shell发送缓冲满处理策略
+ *        使能`SHELL_TX_BUFFER_SIZE`后此宏有意义
+ *        0(SHELL_TX_FULL_BLOCK) 阻塞直到缓冲有空闲
+ *        1(SHELL_TX_FULL_DROP) 丢弃新数据
+ *        2(SHELL_TX_FULL_OVERWRITE) 覆盖最旧的未发送数据，已交给`shell->writeBuffer`的数据不会被覆盖
+ */
+#define     SHELL_TX_FULL_POLICY        0
+
+/**
+ * @brief shell发送缓冲临界区
+ *        使能`SHELL_TX_BUFFER_SIZE`后此宏有意义，在中断中调用`shellTxComplete()`时，
+ *        需要定义为关中断/开中断，如`__disable_irq()`，`__enable_irq()`
+ */
+#define     SHELL_TX_ENTER_CRITICAL()
+#define     SHELL_TX_EXIT_CRITICAL()
+
+/**
+ * @brief 是否使用telnet会话
+ *        使能后可以通过`shell_telnet.c`将shell对象绑定到TCP连接，会话对象从固定的会话池分配
+ */
+#define     SHELL_USING_TELNET          0
+
+/**
+ * @brief telnet会话池大小
+ *        使能宏`SHELL_USING_TELNET`后此宏生效，超过`SHELL_MAX_NUMBER`的会话同样可用
+ */
+#define     SHELL_TELNET_SESSION_NUMBER 8
+
+/**
+ * @brief telnet历史记录缓冲数量
+ *        使能宏`SHELL_USING_TELNET`和`SHELL_HISTORY_ATTACH`后此宏生效，
+ *        会话打开时从历史记录缓冲池获取缓冲，缓冲用完后打开的会话不记录历史
+ */
+#define     SHELL_TELNET_HISTORY_NUMBER 2
+
+/**
+ * @brief telnet发送段大小
+ *        使能宏`SHELL_USING_TELNET`后此宏生效，所有会话共用一个发送段，
+ *        输出在段满或一次接收处理结束时整段发送
+ */
+#define     SHELL_TELNET_SEGMENT_SIZE   256
+
+/**
+ * @brief telnet发送段锁
+ *        多个任务同时处理telnet会话时，需要定义为互斥锁或临界区的获取/释放，
+ *        发送数据函数在锁内调用，不能再产生shell输出
+ */
+#define     SHELL_TELNET_LOCK()
+#define     SHELL_TELNET_UNLOCK()
+
 /**
  * @brief 获取系统时间(ms)
  *        定义此宏为获取系统Tick，如`HAL_GetTick()`
@@ -98,6 +372,26 @@
  */
 #define     SHELL_GET_TICK()            0
 
+/**
+ * @brief 是否使用命令统计
+ *        使能后记录每条命令的执行次数和执行时间，使用`stats`命令查看，`statsClear`命令清除
+ */
+#define     SHELL_USING_STATS           0
+
+/**
+ * @brief 命令统计的最大命令数量
+ *        使能宏`SHELL_USING_STATS`后此宏生效，统计数据按命令条目存放在RAM中，
+ *        执行过的命令超过此数量时，之后第一次执行的命令不统计
+ */
+#define     SHELL_STATS_NUMBER          32
+
+/**
+ * @brief 命令统计计时
+ *        使能宏`SHELL_USING_STATS`后此宏生效，默认使用`SHELL_GET_TICK()`，
+ *        需要更高精度时可以定义为周期计数器，如`DWT->CYCCNT`
+ */
+#define     SHELL_STATS_TICK()          SHELL_GET_TICK()
+
 /**
  * @brief shell默认提示符
  */
@@ -12,69 +12,76 @@
 #include "shell_cfg.h"
 #include "shell.h"
 #include "shell_ext.h"
+#include "stddef.h"
 
 
 /**
- * @brief 判断数字进制
+ * @brief 无效数字字符
  * 
- * @param string 参数字符串
- * @return NUM_Type 进制
  */
-static NUM_Type shellExtNumType(char *string)
+#define     SHELL_EXT_DIGIT_NONE        0xFF
+
+/**
+ * @brief 数字字符表
+ * 
+ * @note 以`'0'`为起点，按字符查表得到数值，非数字字符为SHELL_EXT_DIGIT_NONE
+ */
+static const unsigned char shellExtDigitTable['f' - '0' + 1] =
 {
-    char *p = string;
-    NUM_Type type = NUM_TYPE_INT;
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9,                               /**< 0-9 */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,                   /**< :-@ */
+    10, 11, 12, 13, 14, 15,                                     /**< A-F */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /**< G-P */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /**< Q-Z */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,                         /**< [-` */
+    10, 11, 12, 13, 14, 15,                                     /**< a-f */
+};
 
-    if ((*p == '0') && ((*(p + 1) == 'x') || (*(p + 1) == 'X')))
-    {
-        type = NUM_TYPE_HEX;
-    }
-    else if ((*p == '0') && ((*(p + 1) == 'b') || (*(p + 1) == 'B')))
-    {
-        type = NUM_TYPE_BIN;
-    }
-    else if (*p == '0')
-    {
-        type = NUM_TYPE_OCT;
-    }
-    
-    while (*p++)
-    {
-        if (*p == '.' && *(p + 1) != 0)
-        {
-            type = NUM_TYPE_FLOAT;
-            break;
-        }
-    }
+/**
+ * @brief 10的幂(单精度)
+ * 
+ * @note 尾数不超过2^24且指数不超过10时，单次乘除即可得到正确舍入的结果
+ */
+static const float shellExtPower10f[] =
+{
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
 
-    return type;
-}
+/**
+ * @brief 10的幂(双精度)
+ * 
+ */
+static const double shellExtPower10[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * @brief 数字解析结果
+ * 
+ */
+typedef struct
+{
+    NUM_Type type;                                              /**< 数字类型 */
+    unsigned int value;                                         /**< 整型值 */
+    float valueFloat;                                           /**< 浮点值 */
+} SHELL_ExtNumberTypeDef;
 
 
 /**
  * @brief 字符转数字
  * 
  * @param code 字符
- * @return char 数字
+ * @return unsigned char 数字，非数字字符返回SHELL_EXT_DIGIT_NONE
  */
-static char shellExtToNum(char code)
+static unsigned char shellExtToNum(char code)
 {
-    if ((code >= '0') && (code <= '9'))
-    {
-        return code -'0';
-    }
-    else if ((code >= 'a') && (code <= 'f'))
-    {
-        return code - 'a' + 10;
-    }
-    else if ((code >= 'A') && (code <= 'F'))
+    if (code < '0' || code > 'f')
     {
-        return code - 'A' + 10;
-    }
-    else
-    {
-        return 0;
+        return SHELL_EXT_DIGIT_NONE;
     }
+    return shellExtDigitTable[code - '0'];
 }
 
 
@@ -161,73 +168,248 @@ static char* shellExtParseString(char *string)
 
 
 /**
- * @brief 解析数字参数
+ * @brief 计算浮点数
+ * 
+ * @param mantissa 十进制尾数
+ * @param exponent 十进制指数
+ * @param value 计算结果
+ * @return int 0 成功 -1 溢出
+ */
+static int shellExtScaleFloat(unsigned long long mantissa, int exponent, float *value)
+{
+    double valueDouble;
+
+    if (mantissa == 0)
+    {
+        *value = 0.0f;
+        return 0;
+    }
+    if (mantissa <= (1UL << 24) && exponent >= -10 && exponent <= 10)
+    {
+        *value = (exponent < 0)
+                 ? (float)mantissa / shellExtPower10f[-exponent]
+                 : (float)mantissa * shellExtPower10f[exponent];
+        return 0;
+    }
+    if (exponent > 64)
+    {
+        return -1;
+    }
+    if (exponent < -80)
+    {
+        *value = 0.0f;
+        return 0;
+    }
+    valueDouble = (double)mantissa;
+    while (exponent > 22)
+    {
+        valueDouble *= shellExtPower10[22];
+        exponent -= 22;
+    }
+    while (exponent < -22)
+    {
+        valueDouble /= shellExtPower10[22];
+        exponent += 22;
+    }
+    valueDouble = (exponent < 0)
+                  ? valueDouble / shellExtPower10[-exponent]
+                  : valueDouble * shellExtPower10[exponent];
+    if (valueDouble > 3.402823466e+38)
+    {
+        return -1;
+    }
+    *value = (float)valueDouble;
+    return 0;
+}
+
+
+/**
+ * @brief 解析数字
  * 
  * @param string 字符串参数
- * @return unsigned int 解析出的数字
+ * @param number 解析结果
+ * @return int 0 解析成功 -1 格式错误 -2 溢出
+ * 
+ * @note 支持`0x`十六进制，`0b`二进制，`0`开头八进制以及十进制整型，
+ *       十进制可带小数和`e`指数，解析为浮点数，带小数或指数时`0`开头的数字按十进制解析
+ * @note 整型以64位累加，超出32位时返回溢出，负数的绝对值不超过0x80000000
+ * @note 十进制尾数不超过2^24且指数不超过10时浮点数为正确舍入的结果，否则经double计算后
+ *       转换为float，结果与strtof可能相差1ulp(两次舍入)
  */
-static unsigned int shellExtParseNumber(char *string)
+static int shellExtScanNumber(char *string, SHELL_ExtNumberTypeDef *number)
 {
-    NUM_Type type = NUM_TYPE_INT;
-    char radix = 10;
     char *p = string;
-    char offset = 0;
-    signed char sign = 1;
-    unsigned int valueInt = 0;
-    float valueFloat = 0.0;
-    unsigned int devide = 0;
+    char *q;
+    unsigned int value = 0;
+    unsigned long long mantissa;
+    unsigned char radix = 10;
+    unsigned char digit;
+    unsigned char negative = 0;
+    unsigned short digits = 0;
+    int exponent = 0;
+    int exponentValue = 0;
+    signed char exponentSign = 1;
 
-    if (*string == '-')
+    number->type = NUM_TYPE_INT;
+    if (*p == '-' || *p == '+')
     {
-        sign = -1;
+        negative = (*p == '-');
+        p++;
     }
 
-    type = shellExtNumType(string + ((sign == -1) ? 1 : 0));
-
-    switch ((char)type)
+    if (*p == '0' && (*(p + 1) == 'x' || *(p + 1) == 'X'))
     {
-    case NUM_TYPE_HEX:
+        number->type = NUM_TYPE_HEX;
         radix = 16;
-        offset = 2;
-        break;
-    
-    case NUM_TYPE_OCT:
-        radix = 8;
-        offset = 1;
-        break;
-
-    case NUM_TYPE_BIN:
+        p += 2;
+    }
+    else if (*p == '0' && (*(p + 1) == 'b' || *(p + 1) == 'B'))
+    {
+        number->type = NUM_TYPE_BIN;
         radix = 2;
-        offset = 2;
-        break;
-    
-    default:
-        break;
+        p += 2;
+    }
+    else if (*p == '0' && *(p + 1) >= '0' && *(p + 1) <= '9')
+    {
+        q = p + 1;
+        while (*q >= '0' && *q <= '9')
+        {
+            q++;
+        }
+        if (*q != '.' && *q != 'e' && *q != 'E')
+        {
+            number->type = NUM_TYPE_OCT;
+            radix = 8;
+            p++;
+        }
     }
 
-    p = string + offset + ((sign == -1) ? 1 : 0);
+    while (value < 0x0FFFFFFF && (digit = shellExtToNum(*p)) < radix)
+    {
+        value = value * radix + digit;
+        digits++;
+        p++;
+    }
+    mantissa = value;
+    while ((digit = shellExtToNum(*p)) < radix)
+    {
+        if (mantissa < (1ULL << 59))
+        {
+            mantissa = mantissa * radix + digit;
+        }
+        else if (radix == 10)
+        {
+            exponent++;
+        }
+        else
+        {
+            return -2;
+        }
+        digits++;
+        p++;
+    }
 
-    while (*p)
+    if (radix == 10)
     {
         if (*p == '.')
         {
-            devide = 1;
+            number->type = NUM_TYPE_FLOAT;
             p++;
-            continue;
+            while ((digit = shellExtToNum(*p)) < 10)
+            {
+                if (mantissa < (1ULL << 59))
+                {
+                    mantissa = mantissa * 10 + digit;
+                    exponent--;
+                }
+                digits++;
+                p++;
+            }
+        }
+        if ((*p == 'e' || *p == 'E') && digits > 0)
+        {
+            number->type = NUM_TYPE_FLOAT;
+            p++;
+            if (*p == '-' || *p == '+')
+            {
+                exponentSign = (*p == '-') ? -1 : 1;
+                p++;
+            }
+            if (shellExtToNum(*p) >= 10)
+            {
+                return -1;
+            }
+            while ((digit = shellExtToNum(*p)) < 10)
+            {
+                if (exponentValue < 1000)
+                {
+                    exponentValue = exponentValue * 10 + digit;
+                }
+                p++;
+            }
+            exponent += exponentSign * exponentValue;
         }
-        valueInt = valueInt * radix + shellExtToNum(*p);
-        devide *= 10;
-        p++;
     }
-    if (type == NUM_TYPE_FLOAT && devide != 0)
+
+    if (*p != 0 || digits == 0)
     {
-        valueFloat = (float)valueInt / devide * sign;
-        return *(unsigned int *)(&valueFloat);
+        return -1;
+    }
+
+    if (number->type == NUM_TYPE_FLOAT)
+    {
+        if (shellExtScaleFloat(mantissa, exponent, &(number->valueFloat)) != 0)
+        {
+            return -2;
+        }
+        if (negative)
+        {
+            number->valueFloat = -number->valueFloat;
+        }
+        return 0;
+    }
+
+    if (mantissa > 0xFFFFFFFFULL || (negative && mantissa > 0x80000000ULL))
+    {
+        return -2;
+    }
+    number->value = negative ? (unsigned int)(0 - mantissa) : (unsigned int)mantissa;
+    return 0;
+}
+
+
+/**
+ * @brief 解析数字参数
+ * 
+ * @param string 字符串参数
+ * @param value 解析出的数字，浮点数以其二进制表示返回
+ * @return int 0 解析成功 -1 格式错误 -2 溢出
+ */
+static int shellExtParseNumber(char *string, unsigned int *value)
+{
+    SHELL_ExtNumberTypeDef number;
+    int ret;
+    union
+    {
+        unsigned int value;
+        float valueFloat;
+    } result;
+
+    ret = shellExtScanNumber(string, &number);
+    if (ret != 0)
+    {
+        return ret;
+    }
+    if (number.type == NUM_TYPE_FLOAT)
+    {
+        result.valueFloat = number.valueFloat;
+        *value = result.value;
     }
     else
     {
-        return valueInt * sign;
+        *value = number.value;
     }
+    return 0;
 }
 
 
@@ -235,80 +417,450 @@ static unsigned int shellExtParseNumber(char *string)
  * @brief 解析参数
  * 
  * @param string 参数
- * @return unsigned int 解析结果
+ * @return size_t 解析结果，字符串参数返回其地址
  */
-unsigned int shellExtParsePara(char *string)
+size_t shellExtParsePara(char *string)
 {
     if (*string == '\'' && *(string + 1))
     {
-        return (unsigned int)shellExtParseChar(string);
+        return (size_t)shellExtParseChar(string);
     }
     else if (*string == '-' || (*string >= '0' && *string <= '9'))
     {
-        return (unsigned int)shellExtParseNumber(string);
+        unsigned int value;
+        return (shellExtParseNumber(string, &value) == 0) ? value : 0;
     }
 #if SHELL_USING_VAR == 1
     else if (*string == '$' && *(string + 1))
     {
-        return (unsigned int )shellGetVariable(shellGetCurrent(), string);
+        return (unsigned int)shellGetVariable(shellGetCurrent(), string);
     }
 #endif /** SHELL_USING_VAR == 1 */
     else if (*string)
     {
-        return (unsigned int)shellExtParseString(string);
+        return (size_t)shellExtParseString(string);
     }
     return 0;
 }
 
 
 /**
- * @brief 执行命令
+ * @brief 解析已分类的参数
+ * 
+ * @param shell shell对象
+ * @param token 参数
+ * @param type 参数类型
+ * @param value 解析结果
+ * @return int 0 解析成功 -1 数字格式错误 -2 数字溢出
+ * 
+ * @note 参数已由shell完成切分和转义处理，此处按类型直接转换，不再扫描字符串
+ */
+int shellExtParseToken(SHELL_TypeDef *shell, char *token, unsigned char type,
+                       size_t *value)
+{
+    unsigned int number;
+    int ret;
+
+#if SHELL_USING_VAR == 0
+    (void)shell;
+#endif /** SHELL_USING_VAR == 0 */
+    switch (type)
+    {
+    case SHELL_PARAM_CHAR:
+        *value = (unsigned int)*token;
+        break;
+    case SHELL_PARAM_NUMBER:
+        ret = shellExtParseNumber(token, &number);
+        if (ret != 0)
+        {
+            return ret;
+        }
+        *value = number;
+        break;
+#if SHELL_USING_VAR == 1
+    case SHELL_PARAM_VAR:
+        *value = (unsigned int)shellGetVariable(shell, token);
+        break;
+#endif /** SHELL_USING_VAR == 1 */
+    default:
+        *value = (size_t)token;
+        break;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 解析已分类的浮点参数
+ * 
+ * @param shell shell对象
+ * @param token 参数
+ * @param type 参数类型
+ * @param value 解析结果，整数参数按其符号转换为浮点数，如`0xFFFFFFFF`为4294967295.0
+ * @return int 0 解析成功 -1 参数不是数字或变量
+ */
+int shellExtParseFloat(SHELL_TypeDef *shell, char *token, unsigned char type,
+                       float *value)
+{
+    SHELL_ExtNumberTypeDef number;
+
+#if SHELL_USING_VAR == 1
+    if (type == SHELL_PARAM_VAR)
+    {
+        *value = shellGetVariableFloat(shell, token);
+        return 0;
+    }
+#else
+    (void)shell;
+#endif /** SHELL_USING_VAR == 1 */
+    if (type != SHELL_PARAM_NUMBER || shellExtScanNumber(token, &number) != 0)
+    {
+        return -1;
+    }
+    if (number.type == NUM_TYPE_FLOAT)
+    {
+        *value = number.valueFloat;
+    }
+    else
+    {
+        *value = (*token == '-') ? (float)(int)number.value : (float)number.value;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 以整型参数调用命令函数
  * 
  * @param function 执行命令的函数
- * @param argc 参数个数
- * @param argv 参数
- * @return int 返回值
+ * @param count 参数个数(不含命令名)
+ * @param value 参数值
+ * @return int 返回值，参数个数超出范围时返回-1
  */
-int shellExtRun(shellFunction function, int argc, char *argv[])
+int shellExtCall(shellFunction function, int count, const size_t *value)
 {
-    switch (argc)
+    switch (count)
     {
-    case 1:
+    case 0:
         return function();
-        // break;
+    case 1:
+        return function(value[0]);
     case 2:
-        return function(shellExtParsePara(argv[1]));
-        // break;
+        return function(value[0], value[1]);
     case 3:
-        return function(shellExtParsePara(argv[1]), shellExtParsePara(argv[2]));
-        // break;
+        return function(value[0], value[1], value[2]);
     case 4:
-        return function(shellExtParsePara(argv[1]), shellExtParsePara(argv[2]),
-                        shellExtParsePara(argv[3]));
-        // break;
+        return function(value[0], value[1], value[2], value[3]);
     case 5:
-        return function(shellExtParsePara(argv[1]), shellExtParsePara(argv[2]),
-                        shellExtParsePara(argv[3]), shellExtParsePara(argv[4]));
-        // break;
+        return function(value[0], value[1], value[2], value[3], value[4]);
     case 6:
-        return function(shellExtParsePara(argv[1]), shellExtParsePara(argv[2]),
-                        shellExtParsePara(argv[3]), shellExtParsePara(argv[4]),
-                        shellExtParsePara(argv[5]));
-        // break;
+        return function(value[0], value[1], value[2], value[3], value[4],
+                        value[5]);
     case 7:
-        return function(shellExtParsePara(argv[1]), shellExtParsePara(argv[2]),
-                        shellExtParsePara(argv[3]), shellExtParsePara(argv[4]),
-                        shellExtParsePara(argv[5]), shellExtParsePara(argv[6]));
-        // break;
-    case 8:
-        return function(shellExtParsePara(argv[1]), shellExtParsePara(argv[2]),
-                        shellExtParsePara(argv[3]), shellExtParsePara(argv[4]),
-                        shellExtParsePara(argv[5]), shellExtParsePara(argv[6]),
-                        shellExtParsePara(argv[7]));
-        // break;
+        return function(value[0], value[1], value[2], value[3], value[4],
+                        value[5], value[6]);
+    default:
+        return -1;
+    }
+}
+
+
+/**
+ * @brief 执行命令
+ * 
+ * @param shell shell对象
+ * @param function 执行命令的函数
+ * @param argc 参数个数
+ * @param argv 参数
+ * @return int 返回值，参数个数超出范围或数字溢出时返回-1
+ * 
+ * @note 参数类型取自shell->paramType，形如数字但无法解析的参数(如`-v`，`192.168.1.1`，
+ *       `3rd`)按字符串传递，数字超出范围时输出错误信息，不执行命令
+ */
+int shellExtRun(SHELL_TypeDef *shell, shellFunction function, int argc, char *argv[])
+{
+    size_t value[SHELL_PARAMETER_MAX_NUMBER];
+    int ret;
+
+    if (argc < 1 || argc > 8 || argc > SHELL_PARAMETER_MAX_NUMBER)
+    {
+        return -1;
+    }
+    for (int i = 1; i < argc; i++)
+    {
+        ret = shellExtParseToken(shell, argv[i], shell->paramType[i], &value[i - 1]);
+        if (ret == -2)
+        {
+            shellDisplay(shell, "number overflow: ");
+            shellDisplay(shell, argv[i]);
+            shellDisplay(shell, "\r\n");
+            return -1;
+        }
+        else if (ret != 0)
+        {
+            value[i - 1] = (size_t)argv[i];
+        }
+    }
+    return shellExtCall(function, argc - 1, value);
+}
+
+
+#if SHELL_TYPED_COMMAND == 1
+/**
+ * @brief 类型化参数
+ * 
+ * @note 整型，字符和字符串参数以指针宽度的整型传递，浮点参数以float传递
+ */
+typedef union
+{
+    size_t value;                                               /**< 整型，字符，字符串参数 */
+    float valueFloat;                                           /**< 浮点参数 */
+} SHELL_ExtArgTypeDef;
+
+/**
+ * @brief 类型化调用
+ * 
+ * @note case值由参数个数和浮点参数位图组成，每个case以确定的函数原型调用命令函数，
+ *       参数按该原型传递，不依赖浮点数通过整型寄存器传递
+ */
+#define     SHELL_EXT_T0                size_t
+#define     SHELL_EXT_T1                float
+#define     SHELL_EXT_A0(n)             arg[n].value
+#define     SHELL_EXT_A1(n)             arg[n].valueFloat
+#define     SHELL_EXT_CASE1(a0)                                             \
+            case ((1 << 8) | (a0)):                                         \
+                return ((int (*)(SHELL_EXT_T##a0))function)                 \
+                       (SHELL_EXT_A##a0(0))
+#define     SHELL_EXT_CASE2(a0, a1)                                         \
+            case ((2 << 8) | (a0) | ((a1) << 1)):                           \
+                return ((int (*)(SHELL_EXT_T##a0, SHELL_EXT_T##a1))function)\
+                       (SHELL_EXT_A##a0(0), SHELL_EXT_A##a1(1))
+#define     SHELL_EXT_CASE3(a0, a1, a2)                                     \
+            case ((3 << 8) | (a0) | ((a1) << 1) | ((a2) << 2)):             \
+                return ((int (*)(SHELL_EXT_T##a0, SHELL_EXT_T##a1,          \
+                                 SHELL_EXT_T##a2))function)                 \
+                       (SHELL_EXT_A##a0(0), SHELL_EXT_A##a1(1),             \
+                        SHELL_EXT_A##a2(2))
+#define     SHELL_EXT_CASE4(a0, a1, a2, a3)                                 \
+            case ((4 << 8) | (a0) | ((a1) << 1) | ((a2) << 2) | ((a3) << 3)): \
+                return ((int (*)(SHELL_EXT_T##a0, SHELL_EXT_T##a1,          \
+                                 SHELL_EXT_T##a2, SHELL_EXT_T##a3))function)\
+                       (SHELL_EXT_A##a0(0), SHELL_EXT_A##a1(1),             \
+                        SHELL_EXT_A##a2(2), SHELL_EXT_A##a3(3))
+
+
+/**
+ * @brief 按签名转换参数
+ * 
+ * @param shell shell对象
+ * @param sign 参数签名字符
+ * @param token 参数
+ * @param type 参数类型
+ * @param arg 转换结果
+ * @return int 0 转换成功 -1 签名字符无效或参数错误
+ */
+static int shellExtConvert(SHELL_TypeDef *shell, char sign, char *token,
+                           unsigned char type, SHELL_ExtArgTypeDef *arg)
+{
+    size_t value;
+
+    switch (sign)
+    {
+    case 'i':
+        if (type == SHELL_PARAM_STRING
+            || shellExtParseToken(shell, token, type, &value) != 0)
+        {
+            return -1;
+        }
+        arg->value = (size_t)(int)value;
+        break;
+    case 'c':
+        if (type == SHELL_PARAM_NUMBER || type == SHELL_PARAM_VAR)
+        {
+            if (shellExtParseToken(shell, token, type, &value) != 0)
+            {
+                return -1;
+            }
+            arg->value = (size_t)(char)value;
+        }
+        else
+        {
+            arg->value = (size_t)*token;
+        }
+        break;
+    case 's':
+        arg->value = (size_t)token;
+        break;
+    case 'f':
+        if (shellExtParseFloat(shell, token, type, &arg->valueFloat) != 0)
+        {
+            return -1;
+        }
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief 按类型调用命令函数
+ * 
+ * @param function 执行命令的函数
+ * @param key 参数个数(高8位)和浮点参数位图(低8位)
+ * @param arg 参数
+ * @return int 返回值
+ */
+static int shellExtInvoke(shellFunction function, unsigned short key, SHELL_ExtArgTypeDef *arg)
+{
+    if (key == 0)
+    {
+        return function();
+    }
+    switch (key)
+    {
+    SHELL_EXT_CASE1(0);
+    SHELL_EXT_CASE1(1);
+    SHELL_EXT_CASE2(0, 0);
+    SHELL_EXT_CASE2(1, 0);
+    SHELL_EXT_CASE2(0, 1);
+    SHELL_EXT_CASE2(1, 1);
+    SHELL_EXT_CASE3(0, 0, 0);
+    SHELL_EXT_CASE3(1, 0, 0);
+    SHELL_EXT_CASE3(0, 1, 0);
+    SHELL_EXT_CASE3(1, 1, 0);
+    SHELL_EXT_CASE3(0, 0, 1);
+    SHELL_EXT_CASE3(1, 0, 1);
+    SHELL_EXT_CASE3(0, 1, 1);
+    SHELL_EXT_CASE3(1, 1, 1);
+    SHELL_EXT_CASE4(0, 0, 0, 0);
+    SHELL_EXT_CASE4(1, 0, 0, 0);
+    SHELL_EXT_CASE4(0, 1, 0, 0);
+    SHELL_EXT_CASE4(1, 1, 0, 0);
+    SHELL_EXT_CASE4(0, 0, 1, 0);
+    SHELL_EXT_CASE4(1, 0, 1, 0);
+    SHELL_EXT_CASE4(0, 1, 1, 0);
+    SHELL_EXT_CASE4(1, 1, 1, 0);
+    SHELL_EXT_CASE4(0, 0, 0, 1);
+    SHELL_EXT_CASE4(1, 0, 0, 1);
+    SHELL_EXT_CASE4(0, 1, 0, 1);
+    SHELL_EXT_CASE4(1, 1, 0, 1);
+    SHELL_EXT_CASE4(0, 0, 1, 1);
+    SHELL_EXT_CASE4(1, 0, 1, 1);
+    SHELL_EXT_CASE4(0, 1, 1, 1);
+    SHELL_EXT_CASE4(1, 1, 1, 1);
+    case (5 << 8):
+        return ((int (*)(size_t, size_t, size_t, size_t, size_t))function)
+               (arg[0].value, arg[1].value, arg[2].value, arg[3].value,
+                arg[4].value);
+    case (6 << 8):
+        return ((int (*)(size_t, size_t, size_t, size_t, size_t, size_t))function)
+               (arg[0].value, arg[1].value, arg[2].value, arg[3].value,
+                arg[4].value, arg[5].value);
+    case (7 << 8):
+        return ((int (*)(size_t, size_t, size_t, size_t, size_t, size_t,
+                         size_t))function)
+               (arg[0].value, arg[1].value, arg[2].value, arg[3].value,
+                arg[4].value, arg[5].value, arg[6].value);
     default:
         return -1;
-        // break;
     }
 }
 
+
+/**
+ * @brief 按签名执行命令
+ * 
+ * @param shell shell对象
+ * @param signature 参数签名，每个字符对应一个参数，
+ *                  `i`整型，`c`字符，`s`字符串，`f`浮点，例如"iifs"
+ * @param function 执行命令的函数
+ * @param argc 参数个数
+ * @param argv 参数
+ * @return int 返回值，参数个数与签名不符时返回-1
+ * 
+ * @note 含浮点参数时最多支持4个参数，不含浮点参数时最多支持7个参数
+ */
+int shellExtRunTyped(SHELL_TypeDef *shell, const char *signature,
+                     shellFunction function, int argc, char *argv[])
+{
+    SHELL_ExtArgTypeDef arg[SHELL_PARAMETER_MAX_NUMBER];
+    unsigned short key = 0;
+    int count = 0;
+
+    while (signature[count])
+    {
+        if (count + 1 >= argc
+            || shellExtConvert(shell, signature[count], argv[count + 1],
+                               shell->paramType[count + 1], &arg[count]) != 0)
+        {
+            return -1;
+        }
+        if (signature[count] == 'f')
+        {
+            key |= 1 << count;
+        }
+        count++;
+    }
+    if (count + 1 != argc)
+    {
+        return -1;
+    }
+    return shellExtInvoke(function, (count == 0) ? 0 : (key | (count << 8)), arg);
+}
+
+
+/**
+ * @brief 按签名以二进制参数调用命令
+ * 
+ * @param signature 参数签名
+ * @param function 执行命令的函数
+ * @param count 参数个数(不含命令名)
+ * @param value 参数值，浮点参数为其二进制表示
+ * @param returnValue 命令返回值
+ * @return int 0 调用成功 -1 参数个数与签名不符或签名包含字符串参数
+ */
+int shellExtCallTyped(const char *signature, shellFunction function,
+                      int count, const size_t *value, int *returnValue)
+{
+    SHELL_ExtArgTypeDef arg[SHELL_PARAMETER_MAX_NUMBER];
+    unsigned short key = 0;
+    int i = 0;
+    union
+    {
+        unsigned int value;
+        float valueFloat;
+    } number;
+
+    for (; signature[i]; i++)
+    {
+        if (i >= count || i >= SHELL_PARAMETER_MAX_NUMBER)
+        {
+            return -1;
+        }
+        switch (signature[i])
+        {
+        case 'i':
+            arg[i].value = (size_t)(int)value[i];
+            break;
+        case 'c':
+            arg[i].value = (size_t)(char)value[i];
+            break;
+        case 'f':
+            number.value = (unsigned int)value[i];
+            arg[i].valueFloat = number.valueFloat;
+            key |= 1 << i;
+            break;
+        default:
+            return -1;
+        }
+    }
+    if (i != count || (i > 4 && key != 0))
+    {
+        return -1;
+    }
+    *returnValue = shellExtInvoke(function, (i == 0) ? 0 : (key | (i << 8)), arg);
+    return 0;
+}
+#endif /** SHELL_TYPED_COMMAND == 1 */
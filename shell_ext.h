@@ -13,6 +13,7 @@
 #define __SHELL_EXT_H__
 
 #include "shell.h"
+#include "stddef.h"
 
 /**
  * @brief 数字类型
@@ -27,7 +28,18 @@ typedef enum
     NUM_TYPE_FLOAT                                          /**< 浮点型 */
 } NUM_Type;
 
-unsigned int shellExtParsePara(char *string);
-int shellExtRun(shellFunction function, int argc, char *argv[]);
+size_t shellExtParsePara(char *string);
+int shellExtParseToken(SHELL_TypeDef *shell, char *token, unsigned char type,
+                       size_t *value);
+int shellExtParseFloat(SHELL_TypeDef *shell, char *token, unsigned char type,
+                       float *value);
+int shellExtCall(shellFunction function, int count, const size_t *value);
+int shellExtRun(SHELL_TypeDef *shell, shellFunction function, int argc, char *argv[]);
+#if SHELL_TYPED_COMMAND == 1
+int shellExtRunTyped(SHELL_TypeDef *shell, const char *signature,
+                     shellFunction function, int argc, char *argv[]);
+int shellExtCallTyped(const char *signature, shellFunction function,
+                      int count, const size_t *value, int *returnValue);
+#endif /** SHELL_TYPED_COMMAND == 1 */
 
 #endif
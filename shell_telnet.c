@@ -0,0 +1,386 @@
+/**
+ * @file shell_telnet.c
+ * @author Letter (NevermindZZT@gmail.com)
+ * @brief shell telnet transport
+ * @version 1.0.0
+ * @date 2019-12-10
+ * 
+ * @Copyright (c) 2019 Letter
+ * 
+ */
+
+#include "shell_cfg.h"
+#include "shell.h"
+#include "shell_telnet.h"
+#include "string.h"
+
+#if SHELL_USING_TELNET == 1
+
+/**
+ * @brief telnet命令定义
+ * 
+ */
+#define     TELNET_SE                   240                     /**< 子协商结束 */
+#define     TELNET_IP                   244                     /**< 中断进程 */
+#define     TELNET_SB                   250                     /**< 子协商开始 */
+#define     TELNET_WILL                 251
+#define     TELNET_WONT                 252
+#define     TELNET_DO                   253
+#define     TELNET_DONT                 254
+#define     TELNET_IAC                  255
+
+/**
+ * @brief telnet选项定义
+ * 
+ */
+#define     TELNET_OPTION_ECHO          1                       /**< 回显 */
+#define     TELNET_OPTION_SGA           3                       /**< 抑制继续进行 */
+
+/**
+ * @brief telnet接收状态
+ * 
+ */
+enum
+{
+    TELNET_STATE_DATA = 0,                                  /**< 普通数据 */
+    TELNET_STATE_CR,                                        /**< 收到回车 */
+    TELNET_STATE_IAC,                                       /**< 收到IAC */
+    TELNET_STATE_OPTION,                                    /**< 收到选项协商命令 */
+    TELNET_STATE_SB,                                        /**< 子协商数据 */
+    TELNET_STATE_SB_IAC,                                    /**< 子协商中收到IAC */
+};
+
+static SHELL_TelnetSessionDef shellTelnetPool[SHELL_TELNET_SESSION_NUMBER]; /**< 会话池 */
+static shellTelnetSend shellTelnetSendData = NULL;          /**< 发送数据函数 */
+static char shellTelnetSegment[SHELL_TELNET_SEGMENT_SIZE];  /**< 发送段 */
+static unsigned short shellTelnetLength = 0;                /**< 发送段数据长度 */
+static SHELL_TelnetSessionDef *shellTelnetOwner = NULL;     /**< 发送段所属会话 */
+#if SHELL_HISTORY_ATTACH == 1
+static char shellTelnetHistory[SHELL_TELNET_HISTORY_NUMBER][SHELL_HISTORY_BUFFER_SIZE]; /**< 历史记录缓冲池 */
+static unsigned char shellTelnetHistoryUsed[SHELL_TELNET_HISTORY_NUMBER];  /**< 历史记录缓冲是否已分配 */
+#endif /** SHELL_HISTORY_ATTACH == 1 */
+
+
+/**
+ * @brief telnet初始化
+ * 
+ * @param send 发送数据函数，如lwip的`tcp_write()`或socket的`send()`的封装
+ */
+void shellTelnetInit(shellTelnetSend send)
+{
+    SHELL_TELNET_LOCK();
+    shellTelnetSendData = send;
+    shellTelnetLength = 0;
+    shellTelnetOwner = NULL;
+    for (unsigned short i = 0; i < SHELL_TELNET_SESSION_NUMBER; i++)
+    {
+        shellTelnetPool[i].used = 0;
+    }
+#if SHELL_HISTORY_ATTACH == 1
+    for (unsigned short i = 0; i < SHELL_TELNET_HISTORY_NUMBER; i++)
+    {
+        shellTelnetHistoryUsed[i] = 0;
+    }
+#endif /** SHELL_HISTORY_ATTACH == 1 */
+    SHELL_TELNET_UNLOCK();
+}
+
+
+/**
+ * @brief telnet发送发送段中的数据
+ * 
+ * @note 需要在`SHELL_TELNET_LOCK()`内调用
+ */
+static void shellTelnetSendSegment(void)
+{
+    if (shellTelnetLength > 0 && shellTelnetOwner && shellTelnetSendData)
+    {
+        shellTelnetSendData(shellTelnetOwner->connection, shellTelnetSegment, shellTelnetLength);
+    }
+    shellTelnetLength = 0;
+}
+
+
+/**
+ * @brief telnet发送发送段中的数据
+ * 
+ * @note 一次接收处理结束时会自动调用，在接收处理之外产生输出(如变量监视)后需要手动调用
+ */
+void shellTelnetFlush(void)
+{
+    SHELL_TELNET_LOCK();
+    shellTelnetSendSegment();
+    SHELL_TELNET_UNLOCK();
+}
+
+
+/**
+ * @brief telnet写字节到发送段
+ * 
+ * @param session telnet会话
+ * @param data 字节
+ * 
+ * @note 发送段属于其他会话时，先发送其他会话的数据，需要在`SHELL_TELNET_LOCK()`内调用
+ */
+static void shellTelnetPut(SHELL_TelnetSessionDef *session, unsigned char data)
+{
+    if (shellTelnetOwner != session)
+    {
+        shellTelnetSendSegment();
+        shellTelnetOwner = session;
+    }
+    if (shellTelnetLength >= SHELL_TELNET_SEGMENT_SIZE)
+    {
+        shellTelnetSendSegment();
+    }
+    shellTelnetSegment[shellTelnetLength++] = data;
+}
+
+
+/**
+ * @brief telnet发送选项协商
+ * 
+ * @param session telnet会话
+ * @param command 协商命令
+ * @param option 选项
+ */
+static void shellTelnetOption(SHELL_TelnetSessionDef *session,
+                              unsigned char command, unsigned char option)
+{
+    SHELL_TELNET_LOCK();
+    shellTelnetPut(session, TELNET_IAC);
+    shellTelnetPut(session, command);
+    shellTelnetPut(session, option);
+    SHELL_TELNET_UNLOCK();
+}
+
+
+/**
+ * @brief telnet写数据
+ * 
+ * @param session telnet会话
+ * @param data 数据
+ * @param length 数据长度
+ * 
+ * @note shell的输出通过此函数写入发送段，数据中的IAC字节会被转义，
+ *       一次写入的数据在锁内完成，不会与其他会话的输出交错
+ */
+void shellTelnetWrite(void *session, const char *data, unsigned short length)
+{
+    SHELL_TELNET_LOCK();
+    while (length--)
+    {
+        if ((unsigned char)*data == TELNET_IAC)
+        {
+            shellTelnetPut((SHELL_TelnetSessionDef *)session, TELNET_IAC);
+        }
+        shellTelnetPut((SHELL_TelnetSessionDef *)session, *data++);
+    }
+    SHELL_TELNET_UNLOCK();
+}
+
+
+/**
+ * @brief telnet打开会话
+ * 
+ * @param connection 网络连接
+ * @return SHELL_TypeDef* 会话的shell对象，会话池已满时返回NULL
+ * 
+ * @note 会话打开时协商由服务端回显并抑制继续进行，使客户端工作在字符模式，
+ *       使能`SHELL_HISTORY_ATTACH`时从历史记录缓冲池获取缓冲，缓冲用完时会话不记录历史
+ */
+SHELL_TypeDef *shellTelnetOpen(void *connection)
+{
+    SHELL_TelnetSessionDef *session = NULL;
+
+    SHELL_TELNET_LOCK();
+    for (unsigned short i = 0; i < SHELL_TELNET_SESSION_NUMBER; i++)
+    {
+        if (!shellTelnetPool[i].used)
+        {
+            session = &shellTelnetPool[i];
+            memset(session, 0, sizeof(SHELL_TelnetSessionDef));
+            session->used = 1;
+            break;
+        }
+    }
+#if SHELL_HISTORY_ATTACH == 1
+    for (unsigned short i = 0; session && i < SHELL_TELNET_HISTORY_NUMBER; i++)
+    {
+        if (!shellTelnetHistoryUsed[i])
+        {
+            shellTelnetHistoryUsed[i] = 1;
+            session->shell.history = shellTelnetHistory[i];
+            break;
+        }
+    }
+#endif /** SHELL_HISTORY_ATTACH == 1 */
+    SHELL_TELNET_UNLOCK();
+    if (!session)
+    {
+        return NULL;
+    }
+    session->connection = connection;
+    session->state = TELNET_STATE_DATA;
+    session->shell.session = session;
+
+    shellTelnetOption(session, TELNET_WILL, TELNET_OPTION_ECHO);
+    shellTelnetOption(session, TELNET_WILL, TELNET_OPTION_SGA);
+    shellTelnetOption(session, TELNET_DO, TELNET_OPTION_SGA);
+    shellInit(&session->shell);
+    shellTelnetFlush();
+    return &session->shell;
+}
+
+
+/**
+ * @brief telnet关闭会话
+ * 
+ * @param shell 会话的shell对象
+ * 
+ * @note 会话中未发送的数据会先发送，shell对象从shell列表中移除，历史记录缓冲归还缓冲池，
+ *       调用后可以关闭网络连接
+ */
+void shellTelnetClose(SHELL_TypeDef *shell)
+{
+    SHELL_TelnetSessionDef *session = (SHELL_TelnetSessionDef *)shell->session;
+
+    shellRemove(shell);
+    SHELL_TELNET_LOCK();
+    if (shellTelnetOwner == session)
+    {
+        shellTelnetSendSegment();
+        shellTelnetOwner = NULL;
+    }
+#if SHELL_HISTORY_ATTACH == 1
+    for (unsigned short i = 0; i < SHELL_TELNET_HISTORY_NUMBER; i++)
+    {
+        if (shell->history == shellTelnetHistory[i])
+        {
+            shellTelnetHistoryUsed[i] = 0;
+        }
+    }
+    shell->history = NULL;
+#endif /** SHELL_HISTORY_ATTACH == 1 */
+    session->used = 0;
+    SHELL_TELNET_UNLOCK();
+}
+
+
+/**
+ * @brief telnet处理选项协商
+ * 
+ * @param session telnet会话
+ * @param command 协商命令
+ * @param option 选项
+ * 
+ * @note 回显和抑制继续进行在打开会话时已经请求，不再应答，其他选项一律拒绝
+ */
+static void shellTelnetNegotiate(SHELL_TelnetSessionDef *session,
+                                 unsigned char command, unsigned char option)
+{
+    if (option == TELNET_OPTION_ECHO || option == TELNET_OPTION_SGA)
+    {
+        return;
+    }
+    if (command == TELNET_DO)
+    {
+        shellTelnetOption(session, TELNET_WONT, option);
+    }
+    else if (command == TELNET_WILL)
+    {
+        shellTelnetOption(session, TELNET_DONT, option);
+    }
+}
+
+
+/**
+ * @brief telnet接收数据
+ * 
+ * @param shell 会话的shell对象
+ * @param data 接收的TCP段数据
+ * @param length 数据长度
+ * 
+ * @note 去除telnet命令后，连续的普通数据整段交给shell处理，处理结束后发送产生的输出，
+ *       回车后的'\n'或'\0'会被丢弃，telnet中断进程命令作为Ctrl + C处理，
+ *       同一会话的数据需要在同一个任务中处理，不同会话可以在不同任务中处理
+ */
+void shellTelnetReceive(SHELL_TypeDef *shell, const char *data, unsigned short length)
+{
+    SHELL_TelnetSessionDef *session = (SHELL_TelnetSessionDef *)shell->session;
+    const char *run = data;
+    unsigned char byte;
+
+    for (; length; length--, data++)
+    {
+        byte = (unsigned char)*data;
+        if (session->state == TELNET_STATE_CR)
+        {
+            session->state = TELNET_STATE_DATA;
+            if (byte == '\n' || byte == 0)
+            {
+                shellHandlerBuffer(shell, run, data - run);
+                run = data + 1;
+                continue;
+            }
+        }
+        if (session->state == TELNET_STATE_DATA)
+        {
+            if (byte == TELNET_IAC)
+            {
+                shellHandlerBuffer(shell, run, data - run);
+                run = data + 1;
+                session->state = TELNET_STATE_IAC;
+            }
+            else if (byte == '\r')
+            {
+                session->state = TELNET_STATE_CR;
+            }
+            continue;
+        }
+        run = data + 1;
+        switch (session->state)
+        {
+        case TELNET_STATE_IAC:
+            session->state = TELNET_STATE_DATA;
+            if (byte >= TELNET_WILL && byte <= TELNET_DONT)
+            {
+                session->command = byte;
+                session->state = TELNET_STATE_OPTION;
+            }
+            else if (byte == TELNET_SB)
+            {
+                session->state = TELNET_STATE_SB;
+            }
+            else if (byte == TELNET_IAC)
+            {
+                run = data;
+            }
+            else if (byte == TELNET_IP)
+            {
+                shellHandler(shell, 0x03);
+            }
+            break;
+        case TELNET_STATE_OPTION:
+            shellTelnetNegotiate(session, session->command, byte);
+            session->state = TELNET_STATE_DATA;
+            break;
+        case TELNET_STATE_SB:
+            if (byte == TELNET_IAC)
+            {
+                session->state = TELNET_STATE_SB_IAC;
+            }
+            break;
+        case TELNET_STATE_SB_IAC:
+            session->state = (byte == TELNET_SE) ? TELNET_STATE_DATA : TELNET_STATE_SB;
+            break;
+        default:
+            session->state = TELNET_STATE_DATA;
+            break;
+        }
+    }
+    shellHandlerBuffer(shell, run, data - run);
+    shellTelnetFlush();
+}
+
+#endif /** SHELL_USING_TELNET == 1 */
@@ -0,0 +1,53 @@
+/**
+ * @file shell_telnet.h
+ * @author Letter (NevermindZZT@gmail.com)
+ * @brief shell telnet transport
+ * @version 1.0.0
+ * @date 2019-12-10
+ * 
+ * @Copyright (c) 2019 Letter
+ * 
+ */
+
+#ifndef __SHELL_TELNET_H__
+#define __SHELL_TELNET_H__
+
+#include "shell.h"
+
+#if SHELL_USING_TELNET == 1
+
+/**
+ * @brief telnet发送数据函数原型
+ * 
+ * @param void* 网络连接
+ * @param const char* 需发送的数据
+ * @param unsigned short 数据长度
+ */
+typedef void (*shellTelnetSend)(void *, const char *, unsigned short);
+
+/**
+ * @brief telnet会话定义
+ * 
+ * @note 每个会话需要独立的命令缓冲和参数，因此包含完整的shell对象，
+ *       使能`SHELL_HISTORY_ATTACH`后shell对象中的历史记录改为从缓冲池获取，
+ *       会话大小不再包含历史记录
+ */
+typedef struct
+{
+    SHELL_TypeDef shell;                                    /**< shell对象 */
+    void *connection;                                       /**< 网络连接 */
+    unsigned char used;                                     /**< 会话是否已分配 */
+    unsigned char state;                                    /**< telnet接收状态 */
+    unsigned char command;                                  /**< 正在接收的选项协商命令 */
+} SHELL_TelnetSessionDef;
+
+void shellTelnetInit(shellTelnetSend send);
+SHELL_TypeDef *shellTelnetOpen(void *connection);
+void shellTelnetClose(SHELL_TypeDef *shell);
+void shellTelnetReceive(SHELL_TypeDef *shell, const char *data, unsigned short length);
+void shellTelnetFlush(void);
+void shellTelnetWrite(void *session, const char *data, unsigned short length);
+
+#endif /** SHELL_USING_TELNET == 1 */
+
+#endif